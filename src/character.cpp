@@ -6244,11 +6244,48 @@ bool Character::is_visible_in_range( const Creature &critter, const int range )
 std::vector<Creature *> Character::get_visible_creatures( const int range ) const
 {
     const map &here = get_map();
-
-    return g->get_creatures_if( [this, range, &here]( const Creature & critter ) -> bool {
+    const auto visible = [this, range, &here]( const Creature & critter ) {
         return this != &critter && pos_abs() != critter.pos_abs() &&
-        rl_dist( pos_abs(), critter.pos_abs() ) <= range && sees( here, critter );
+               rl_dist( pos_abs(), critter.pos_abs() ) <= range && sees( here, critter );
+    };
+
+    std::vector<Creature *> result;
+    // Only look at the monsters near us instead of every monster in the bubble
+    const tripoint_abs_ms bubble_min = here.get_abs( tripoint_bub_ms( 0, 0, -OVERMAP_DEPTH ) );
+    const tripoint_abs_ms bubble_max = here.get_abs( tripoint_bub_ms( MAPSIZE_X - 1, MAPSIZE_Y - 1,
+                                       OVERMAP_HEIGHT ) );
+    const tripoint_abs_ms pos = pos_abs();
+    const tripoint_abs_ms min( std::max( pos.x() - range, bubble_min.x() ),
+                               std::max( pos.y() - range, bubble_min.y() ),
+                               std::max( pos.z() - range, bubble_min.z() ) );
+    const tripoint_abs_ms max( std::min( pos.x() + range, bubble_max.x() ),
+                               std::min( pos.y() + range, bubble_max.y() ),
+                               std::min( pos.z() + range, bubble_max.z() ) );
+    for( monster *critter : get_creature_tracker().monsters_in( min, max ) ) {
+        if( visible( *critter ) ) {
+            result.push_back( critter );
+        }
+    }
+    // The index returns monsters in no meaningful order, callers like
+    // game::is_hostile_within() report the first match so make it the nearest one.
+    std::sort( result.begin(), result.end(), [&pos]( const Creature * lhs, const Creature * rhs ) {
+        const int lhs_dist = rl_dist( pos, lhs->pos_abs() );
+        const int rhs_dist = rl_dist( pos, rhs->pos_abs() );
+        if( lhs_dist != rhs_dist ) {
+            return lhs_dist < rhs_dist;
+        }
+        return lhs->pos_abs() < rhs->pos_abs();
     } );
+    for( npc &guy : g->all_npcs() ) {
+        if( visible( guy ) ) {
+            result.push_back( &guy );
+        }
+    }
+    avatar &you = get_avatar();
+    if( visible( you ) ) {
+        result.push_back( &you );
+    }
+    return result;
 }
 
 std::vector<vehicle *> Character::get_visible_vehicles( const int range ) const
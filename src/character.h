@@ -3386,6 +3386,7 @@ class Character : public Creature, public visitable
          * The player character (g->u) is checked and might be included (if applicable).
          * @param range The maximal distance (@ref rl_dist), creatures at this distance or less
          * are included.
+         * Monsters come first, nearest first, followed by the NPCs and the player character.
          */
         std::vector<Creature *> get_visible_creatures( int range ) const;
         /**
@@ -13,6 +13,7 @@
 #include "flood_fill.h"
 #include "game.h"
 #include "map.h"
+#include "map_scale_constants.h"
 #include "mapdata.h"
 #include "maptile_fwd.h"
 #include "mongroup.h"
@@ -93,7 +94,7 @@ bool creature_tracker::add( const shared_ptr_fast<monster> &critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.pos_abs()] = critter_ptr;
+    set_location( critter.pos_abs(), critter_ptr );
     return true;
 }
 
@@ -130,8 +131,11 @@ bool creature_tracker::update_pos( const monster &critter, const tripoint_abs_ms
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( old_pos );
-        monsters_by_location[new_pos] = *iter;
+        const auto old_iter = monsters_by_location.find( old_pos );
+        if( old_iter != monsters_by_location.end() ) {
+            erase_location( old_iter );
+        }
+        set_location( new_pos, *iter );
         return true;
     } else {
         // We're changing the x/y/z coordinates of a zombie that hasn't been added
@@ -148,7 +152,7 @@ void creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.pos_abs() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_location( pos_iter );
         return;
     }
 
@@ -159,8 +163,85 @@ void creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_location( iter );
+    }
+}
+
+void creature_tracker::set_location( const tripoint_abs_ms &pos,
+                                     const shared_ptr_fast<monster> &critter )
+{
+    shared_ptr_fast<monster> &entry = monsters_by_location[pos];
+    if( entry == critter ) {
+        return;
+    }
+    std::vector<monster *> &bucket = monsters_by_submap[coords::project_to<coords::sm>( pos )];
+    if( entry ) {
+        // Replacing a monster that was not removed first, e.g. a dead hallucination
+        const auto old_iter = std::find( bucket.begin(), bucket.end(), entry.get() );
+        if( old_iter != bucket.end() ) {
+            *old_iter = bucket.back();
+            bucket.pop_back();
+        }
     }
+    entry = critter;
+    bucket.push_back( critter.get() );
+}
+
+void creature_tracker::erase_location(
+    std::unordered_map<tripoint_abs_ms, shared_ptr_fast<monster>>::iterator iter )
+{
+    const auto bucket_iter = monsters_by_submap.find( coords::project_to<coords::sm>( iter->first ) );
+    if( bucket_iter != monsters_by_submap.end() ) {
+        std::vector<monster *> &bucket = bucket_iter->second;
+        const auto mon_iter = std::find( bucket.begin(), bucket.end(), iter->second.get() );
+        if( mon_iter != bucket.end() ) {
+            *mon_iter = bucket.back();
+            bucket.pop_back();
+        }
+        if( bucket.empty() ) {
+            monsters_by_submap.erase( bucket_iter );
+        }
+    }
+    monsters_by_location.erase( iter );
+}
+
+void creature_tracker::clear_locations()
+{
+    monsters_by_location.clear();
+    monsters_by_submap.clear();
+}
+
+std::vector<monster *> creature_tracker::monsters_in( const tripoint_abs_ms &min,
+        const tripoint_abs_ms &max ) const
+{
+    std::vector<monster *> result;
+    const tripoint_abs_sm min_sm = coords::project_to<coords::sm>( min );
+    const tripoint_abs_sm max_sm = coords::project_to<coords::sm>( max );
+    for( int z = std::max( min.z(), -OVERMAP_DEPTH ); z <= std::min( max.z(), OVERMAP_HEIGHT ); ++z ) {
+        for( int y = min_sm.y(); y <= max_sm.y(); ++y ) {
+            for( int x = min_sm.x(); x <= max_sm.x(); ++x ) {
+                const auto iter = monsters_by_submap.find( tripoint_abs_sm( x, y, z ) );
+                if( iter == monsters_by_submap.end() ) {
+                    continue;
+                }
+                for( monster *critter : iter->second ) {
+                    const tripoint_abs_ms pos = critter->pos_abs();
+                    if( pos.x() >= min.x() && pos.x() <= max.x() && pos.y() >= min.y() &&
+                        pos.y() <= max.y() && !critter->is_dead() ) {
+                        result.push_back( critter );
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<monster *> creature_tracker::monsters_in_radius( const tripoint_abs_ms &center,
+        int radius ) const
+{
+    const tripoint offset( radius, radius, radius );
+    return monsters_in( center - offset, center + offset );
 }
 
 void creature_tracker::remove( const monster &critter )
@@ -182,7 +263,7 @@ void creature_tracker::remove( const monster &critter )
 void creature_tracker::clear()
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    clear_locations();
     removed_this_turn_.clear();
     creatures_by_zone_and_faction_.clear();
     invalidate_reachability_cache();
@@ -190,9 +271,9 @@ void creature_tracker::clear()
 
 void creature_tracker::rebuild_cache()
 {
-    monsters_by_location.clear();
+    clear_locations();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->pos_abs()] = mon_ptr;
+        set_location( mon_ptr->pos_abs(), mon_ptr );
     }
 }
 
@@ -235,13 +316,13 @@ void creature_tracker::swap_positions( monster &first, monster &second )
     shared_ptr_fast<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
+        erase_location( first_iter );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
+        erase_location( second_iter );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -251,10 +332,10 @@ void creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.pos_abs()] = first_ptr;
+        set_location( first.pos_abs(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.pos_abs()] = second_ptr;
+        set_location( second.pos_abs(), second_ptr );
     }
 }
 
@@ -70,6 +70,17 @@ class creature_tracker
         void for_each_reachable( const Creature &origin, FactionPredicateFn &&faction_fn,
                                  CreatureVisitFn &&creature_fn );
 
+        /**
+         * Returns the monsters inside the given box, bounds included.
+         * Only the submaps overlapping the box are looked at, so the cost depends on the
+         * number of monsters near the box rather than on the total number of monsters.
+         * The order is stable but unrelated to @ref get_monsters_list.
+         * Dead monsters are ignored and not returned.
+         */
+        std::vector<monster *> monsters_in( const tripoint_abs_ms &min, const tripoint_abs_ms &max ) const;
+        /** Returns the monsters at most @p radius tiles away from @p center on every axis. */
+        std::vector<monster *> monsters_in_radius( const tripoint_abs_ms &center, int radius ) const;
+
         /**
          * Returns a temporary id of the given monster (which must exist in the tracker).
          * The id is valid until monsters are added or removed from the tracker.
@@ -136,6 +147,11 @@ class creature_tracker
     private:
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+        /** Sets the entry of @ref monsters_by_location at pos, keeping @ref monsters_by_submap in sync. */
+        void set_location( const tripoint_abs_ms &pos, const shared_ptr_fast<monster> &critter );
+        /** Erases an entry of @ref monsters_by_location, keeping @ref monsters_by_submap in sync. */
+        void erase_location( std::unordered_map<tripoint_abs_ms, shared_ptr_fast<monster>>::iterator iter );
+        void clear_locations();
 
         void flood_fill_zone( const Creature &origin );
 
@@ -148,6 +164,9 @@ class creature_tracker
         std::vector<shared_ptr_fast<monster>> monsters_list;
         // NOLINTNEXTLINE(cata-serialize)
         std::unordered_map<tripoint_abs_ms, shared_ptr_fast<monster>> monsters_by_location;
+        /** The monsters of @ref monsters_by_location, bucketed by the submap they are on. */
+        // NOLINTNEXTLINE(cata-serialize)
+        std::unordered_map<tripoint_abs_sm, std::vector<monster *>> monsters_by_submap;
 
         /**
          * Creatures that get removed via @ref remove are stored here until the end of the turn.
@@ -107,6 +107,7 @@
 #include "overmapbuffer.h"
 #include "path_info.h"
 #include "pathfinding.h"
+#include "perf.h"
 #include "pimpl.h"
 #include "point.h"
 #include "popup.h"
@@ -123,6 +124,7 @@
 #include "trait_group.h"
 #include "translation.h"
 #include "translations.h"
+#include "turn_replay.h"
 #include "type_id.h"
 #include "uilist.h"
 #include "ui_manager.h"
@@ -294,6 +296,9 @@ std::string enum_to_string<debug_menu::debug_menu_index>( debug_menu::debug_menu
         case debug_menu::debug_menu_index::TALK_TOPIC: return "TALK_TOPIC";
         case debug_menu::debug_menu_index::IMGUI_DEMO: return "IMGUI_DEMO";
         case debug_menu::debug_menu_index::VEHICLE_EFFECTS: return "VEHICLE_EFFECTS";
+        case debug_menu::debug_menu_index::TURN_PROFILER: return "TURN_PROFILER";
+        case debug_menu::debug_menu_index::EXPORT_TURN_PROFILE: return "EXPORT_TURN_PROFILE";
+        case debug_menu::debug_menu_index::RECORD_TURN_REPLAY: return "RECORD_TURN_REPLAY";
         // *INDENT-ON*
         case debug_menu::debug_menu_index::last:
             break;
@@ -975,6 +980,9 @@ static int info_uilist()
         { uilist_entry( debug_menu_index::SHOW_MUT_CAT, true, 'm', _( "Show mutation category levels" ) ) },
         { uilist_entry( debug_menu_index::BENCHMARK, true, 'b', _( "Draw benchmark (X seconds)" ) ) },
         { uilist_entry( debug_menu_index::HOUR_TIMER, true, 'E', _( "Toggle hour timer" ) ) },
+        { uilist_entry( debug_menu_index::TURN_PROFILER, true, 'P', _( "Toggle turn profiler overlay" ) ) },
+        { uilist_entry( debug_menu_index::EXPORT_TURN_PROFILE, true, 'x', _( "Write turn profile to turn_profile.csv and turn_profile.json" ) ) },
+        { uilist_entry( debug_menu_index::RECORD_TURN_REPLAY, true, 'z', get_turn_replay().is_recording() ? _( "Stop recording turn replay to turn_replay.json" ) : _( "Start recording turn replay" ) ) },
         { uilist_entry( debug_menu_index::TRAIT_GROUP, true, 't', _( "Test trait group" ) ) },
         { uilist_entry( debug_menu_index::DISPLAY_NPC_PATH, true, 'n', _( "Toggle NPC pathfinding on map" ) ) },
         { uilist_entry( debug_menu_index::DISPLAY_NPC_ATTACK, true, 'A', _( "Toggle NPC attack potential values on map" ) ) },
@@ -4020,6 +4028,33 @@ static void run_imgui_demo()
     demo.run();
 }
 
+static void write_turn_profile()
+{
+    const turn_profiler &profiler = get_turn_profiler();
+    write_to_file( "turn_profile.csv", [&]( std::ostream & out ) {
+        profiler.write_csv( out );
+    }, "turn profile" );
+    write_to_file( "turn_profile.json", [&]( std::ostream & out ) {
+        JsonOut jsout( out, true );
+        profiler.serialize( jsout );
+    }, "turn profile" );
+    cata_timer::print_stats();
+    popup( _( "Wrote %d turns to turn_profile.csv and turn_profile.json, and scope timers to the debug log" ),
+           profiler.size() );
+}
+
+static void toggle_turn_replay_recording()
+{
+    turn_replay &replay = get_turn_replay();
+    if( !replay.is_recording() ) {
+        replay.request_recording();
+        popup( _( "The game will be saved and recording will start at the beginning of the next turn." ) );
+    } else if( replay.stop_recording( "turn_replay.json" ) ) {
+        popup( _( "Wrote %d turns to turn_replay.json.  Replay them with cata_bench --replay turn_replay.json" ),
+               replay.get_turns().size() );
+    }
+}
+
 static void write_city_list()
 {
     write_to_file( "cities.output", [&]( std::ostream & testfile ) {
@@ -4348,6 +4383,15 @@ void debug()
         case debug_menu_index::HOUR_TIMER:
             g->toggle_debug_hour_timer();
             break;
+        case debug_menu_index::TURN_PROFILER:
+            g->toggle_turn_profiler_overlay();
+            break;
+        case debug_menu_index::EXPORT_TURN_PROFILE:
+            write_turn_profile();
+            break;
+        case debug_menu_index::RECORD_TURN_REPLAY:
+            toggle_turn_replay_recording();
+            break;
         case debug_menu_index::CHANGE_TIME:
             calendar::turn = calendar_ui::select_time_point( calendar::turn );
             break;
@@ -121,6 +121,9 @@ enum class debug_menu_index : int {
     TALK_TOPIC,
     IMGUI_DEMO,
     VEHICLE_EFFECTS,
+    TURN_PROFILER,
+    EXPORT_TURN_PROFILE,
+    RECORD_TURN_REPLAY,
     last
 };
 
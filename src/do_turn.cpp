@@ -43,7 +43,6 @@
 #include "map_iterator.h"
 #include "map_scale_constants.h"
 #include "mapbuffer.h"
-#include "mapdata.h"
 #include "memorial_logger.h"
 #include "messages.h"
 #include "mission.h"
@@ -55,6 +54,7 @@
 #include "output.h"
 #include "overmap_ui.h"
 #include "overmapbuffer.h"
+#include "perf.h"
 #include "pimpl.h"
 #include "player_activity.h"
 #include "point.h"
@@ -68,6 +68,8 @@
 #include "string_formatter.h"
 #include "timed_event.h"
 #include "translations.h"
+#include "turn_profiler_ui.h"
+#include "turn_replay.h"
 #include "type_id.h"
 #include "uilist.h"
 #include "ui_manager.h"
@@ -205,6 +207,13 @@ bool cleanup_at_end()
         }
     }
 
+    // Don't leave the profiler overlay on top of the main menu
+    g->turn_profiler_overlay.reset();
+    get_turn_profiler().clear();
+    if( get_turn_replay().is_recording() ) {
+        get_turn_replay().stop_recording( "turn_replay.json" );
+    }
+
     //Reset any offset due to driving
     g->set_driving_view_offset( point_rel_ms::zero );
 
@@ -437,8 +446,8 @@ void overmap_npc_move()
                 }
             }
             if( elem->omt_path.empty() ) {
-                elem->omt_path = overmap_buffer.get_travel_path( elem->pos_abs_omt(), elem->goal,
-                                 overmap_path_params::for_npc() ).points;
+                elem->omt_path = overmap_buffer.get_cached_travel_path( elem->pos_abs_omt(),
+                                 elem->goal, overmap_path_params::for_npc() );
                 if( elem->omt_path.empty() ) { // goal is unreachable, or already reached goal, reset it
                     elem->goal = npc::no_goal_point;
                 }
@@ -467,9 +476,13 @@ bool do_turn()
         return turn_handler::cleanup_at_end();
     }
 
+    turn_replay &replay = get_turn_replay();
+    // Loading a save restarts its current turn without advancing the calendar, so a
+    // replay recording starting now has to do the same to stay in step with its replay.
+    const bool restart_turn = replay.begin_turn();
     weather_manager &weather = get_weather();
     // Actual stuff
-    if( g->new_game ) {
+    if( g->new_game || restart_turn ) {
         g->new_game = false;
         if( get_option<std::string>( "ETERNAL_WEATHER" ) != "normal" ) {
             weather.weather_override = static_cast<weather_type_id>
@@ -483,6 +496,8 @@ bool do_turn()
         g->gamemode->per_turn();
         calendar::turn += 1_turns;
     }
+    turn_profiler &profiler = get_turn_profiler();
+    profiler.start_turn( to_turns<int>( calendar::turn - calendar::turn_zero ) );
     //used for dimension swapping
     if( g->swapping_dimensions ) {
         g->swapping_dimensions = false;
@@ -524,7 +539,10 @@ bool do_turn()
     }
 
     // Move hordes every turn, move_hordes has its own rate limiting
-    overmap_buffer.move_hordes();
+    {
+        turn_phase_timer timer( turn_phase::move_hordes );
+        overmap_buffer.move_hordes();
+    }
     if( calendar::once_every( time_duration::from_minutes( 2.5 ) ) ) {
         if( u.has_trait( trait_HAS_NEMESIS ) ) {
             overmap_buffer.move_nemesis();
@@ -539,6 +557,7 @@ bool do_turn()
     if( get_option<bool>( "AUTOSAVE" ) &&
         calendar::once_every( 1_turns * get_option<int>( "AUTOSAVE_TURNS" ) ) &&
         !u.is_dead_state() ) {
+        turn_phase_timer timer( turn_phase::autosave );
         g->autosave();
     }
 
@@ -651,42 +670,50 @@ bool do_turn()
         scent.set( u.pos_bub(), u.scent, u.get_type_of_scent() );
         overmap_buffer.set_scent( u.pos_abs_omt(),  u.scent );
     }
-    scent.update( u.pos_bub(), m );
+    {
+        turn_phase_timer timer( turn_phase::scent_update );
+        scent.update( u.pos_bub(), m );
+    }
 
     // We need floor cache before checking falling 'n stuff
     m.build_floor_caches();
 
     m.process_falling();
-    m.vehmove();
-    m.process_fields();
-    m.process_items();
+    {
+        turn_phase_timer timer( turn_phase::vehmove );
+        m.vehmove();
+    }
+    {
+        turn_phase_timer timer( turn_phase::process_fields );
+        m.process_fields();
+    }
+    {
+        turn_phase_timer timer( turn_phase::process_items );
+        m.process_items();
+    }
     explosion_handler::process_explosions();
     m.creature_in_field( u );
 
     // Apply sounds from previous turn to monster and NPC AI.
-    sounds::process_sounds();
+    {
+        turn_phase_timer timer( turn_phase::process_sounds );
+        sounds::process_sounds();
+    }
     const int levz = m.get_abs_sub().z();
     // Update vision caches for monsters. If this turns out to be expensive,
     // consider a stripped down cache just for monsters.
-    m.build_map_cache( levz, true );
-    monmove();
+    {
+        turn_phase_timer timer( turn_phase::build_map_cache );
+        m.build_map_cache( levz, true );
+    }
+    {
+        turn_phase_timer timer( turn_phase::monmove );
+        monmove();
+    }
     if( calendar::once_every( time_between_npc_OM_moves ) ) {
         overmap_npc_move();
     }
-    if( calendar::once_every( 10_seconds ) ) {
-        for( const tripoint_bub_ms &elem : m.get_furn_field_locations() ) {
-            const furn_t &furn = *m.furn( elem );
-            for( const emit_id &e : furn.emissions ) {
-                m.emit_field( elem, e );
-            }
-        }
-        for( const tripoint_bub_ms &elem : m.get_ter_field_locations() ) {
-            const ter_t &ter = *m.ter( elem );
-            for( const emit_id &e : ter.emissions ) {
-                m.emit_field( elem, e );
-            }
-        }
-    }
+    m.emit_fields_due();
     g->mon_info_update();
     u.process_turn();
     if( u.get_moves() < 0 && get_option<bool>( "FORCE_REDRAW" ) ) {
@@ -782,5 +809,7 @@ bool do_turn()
     EM_ASM( window.game_unsaved = true; );
 #endif
 
+    profiler.finish_turn();
+    replay.end_turn( profiler.get_record( 0 ).total_us() );
     return false;
 }
@@ -78,17 +78,21 @@ time_duration field_entry::get_field_age() const
 
 Creature *field_entry::get_causer() const
 {
-    return causer.resolve_creature();
+    return causer ? causer->resolve_creature() : nullptr;
 }
 
 void field_entry::set_causer( effect_source source )
 {
-    causer = source;
+    if( source.get_character_id() || source.get_faction_id() || source.get_mfaction_id() ) {
+        causer = cata::make_value<effect_source>( std::move( source ) );
+    } else {
+        causer.reset();
+    }
 }
 
 effect_source field_entry::get_effect_source() const
 {
-    return causer;
+    return causer ? *causer : effect_source();
 }
 
 time_duration field_entry::set_field_age( const time_duration &new_age )
@@ -136,6 +140,13 @@ field::field()
 {
 }
 
+// What begin() and end() point into on tiles that never had a field.
+static std::map<field_type_id, field_entry> &no_fields()
+{
+    static std::map<field_type_id, field_entry> empty;
+    return empty;
+}
+
 /*
 Function: find_field
 Returns a field entry corresponding to the field_type_id parameter passed in. If no fields are found then returns NULL.
@@ -181,6 +192,9 @@ bool field::add_field( const field_type_id &field_type_to_add, const int new_int
     if( !field_type_to_add ) {
         return false;
     }
+    if( !_field_type_list ) {
+        _field_type_list = cata::make_value<std::map<field_type_id, field_entry>>();
+    }
     auto it = _field_type_list->find( field_type_to_add );
     if( it != _field_type_list->end() ) {
         //Already exists, but lets update it. This is tentative.
@@ -197,13 +211,16 @@ bool field::add_field( const field_type_id &field_type_to_add, const int new_int
         field_type_to_add.obj().priority >= _displayed_field_type.obj().priority ) {
         _displayed_field_type = field_type_to_add;
     }
-    _field_type_list[field_type_to_add] = field_entry( field_type_to_add, new_intensity, new_age,
-                                          source );
+    ( *_field_type_list )[field_type_to_add] = field_entry( field_type_to_add, new_intensity,
+            new_age, source );
     return true;
 }
 
 bool field::remove_field( const field_type_id &field_to_remove )
 {
+    if( !_field_type_list ) {
+        return false;
+    }
     const auto it = _field_type_list->find( field_to_remove );
     if( it == _field_type_list->end() ) {
         return false;
@@ -225,7 +242,7 @@ void field::remove_field( std::map<field_type_id, field_entry>::iterator const i
 
 void field::clear()
 {
-    _field_type_list->clear();
+    _field_type_list.reset();
     _displayed_field_type = fd_null;
 }
 
@@ -235,27 +252,27 @@ Returns the number of fields existing on the current tile.
 */
 unsigned int field::field_count() const
 {
-    return _field_type_list->size();
+    return _field_type_list ? _field_type_list->size() : 0;
 }
 
 std::map<field_type_id, field_entry>::iterator field::begin()
 {
-    return _field_type_list->begin();
+    return _field_type_list ? _field_type_list->begin() : no_fields().begin();
 }
 
 std::map<field_type_id, field_entry>::const_iterator field::begin() const
 {
-    return _field_type_list->begin();
+    return _field_type_list ? _field_type_list->begin() : no_fields().begin();
 }
 
 std::map<field_type_id, field_entry>::iterator field::end()
 {
-    return _field_type_list->end();
+    return _field_type_list ? _field_type_list->end() : no_fields().end();
 }
 
 std::map<field_type_id, field_entry>::const_iterator field::end() const
 {
-    return _field_type_list->end();
+    return _field_type_list ? _field_type_list->end() : no_fields().end();
 }
 
 /*
@@ -281,7 +298,7 @@ int field::displayed_intensity() const
 int field::total_move_cost() const
 {
     int current_cost = 0;
-    for( const auto &fld : *_field_type_list ) {
+    for( const auto &fld : *this ) {
         current_cost += fld.second.get_intensity_level().move_cost;
     }
     return current_cost;
@@ -289,7 +306,7 @@ int field::total_move_cost() const
 
 bool field::any_negative_move_cost() const
 {
-    for( const auto &fld : *_field_type_list ) {
+    for( const auto &fld : *this ) {
         if( fld.second.get_intensity_level().move_cost < 0 ) {
             return true;
         }
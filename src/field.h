@@ -7,12 +7,12 @@
 #include <vector>
 
 #include "calendar.h"
-#include "cata_lazy.h"
 #include "color.h"
 #include "effect_source.h"
 #include "enums.h"
 #include "field_type.h"
 #include "type_id.h"
+#include "value_ptr.h"
 
 class Creature;
 
@@ -26,8 +26,10 @@ class field_entry
         field_entry() : type( fd_null.id_or( INVALID_FIELD_TYPE_ID ) ), intensity( 1 ), age( 0_turns ),
             is_alive( false ) { }
         field_entry( const field_type_id &t, const int i, const time_duration &a,
-                     effect_source source = effect_source() ) : type( t ),
-            intensity( i ), age( a ), causer( source ), is_alive( true ) { }
+                     const effect_source &source = effect_source() ) : type( t ),
+            intensity( i ), age( a ), is_alive( true ) {
+            set_causer( source );
+        }
 
         nc_color color() const;
 
@@ -101,12 +103,13 @@ class field_entry
         int intensity;
         // The age, of the field effect. 0 is permanent.
         time_duration age;
-        // The creature responsible for this field, if any.
-        effect_source causer;
         // The time when the field will decay, initialized to 0.
         time_point decay_time;
         // True if this is an active field, false if it should be destroyed next check.
         bool is_alive;
+        // The creature responsible for this field, if any.  Most fields have none, so it is only
+        // allocated for those that do, which keeps the entries small.
+        cata::value_ptr<effect_source> causer;
 };
 
 /**
@@ -197,8 +200,9 @@ class field
         bool any_negative_move_cost() const;
 
     private:
-        // A pointer lookup table of all field effects on the current tile.
-        lazy<std::map<field_type_id, field_entry>> _field_type_list;
+        // A pointer lookup table of all field effects on the current tile.  Most tiles never have
+        // a field, so it is only allocated by the first one added, and freed by clear().
+        cata::value_ptr<std::map<field_type_id, field_entry>> _field_type_list;
         //_displayed_field_type currently is equal to the last field added to the square. You can modify this behavior in the class functions if you wish.
         field_type_id _displayed_field_type;
 };
@@ -202,6 +202,7 @@
 #include "translation_cache.h"
 #include "translations.h"
 #include "trap.h"
+#include "turn_profiler_ui.h"
 #include "ui_helpers.h"
 #include "ui_extended_description.h"
 #include "ui_manager.h"
@@ -10480,6 +10481,15 @@ void game::toggle_debug_hour_timer()
     debug_hour_timer.toggle();
 }
 
+void game::toggle_turn_profiler_overlay()
+{
+    if( turn_profiler_overlay ) {
+        turn_profiler_overlay.reset();
+    } else {
+        turn_profiler_overlay = std::make_unique<turn_profiler_ui>();
+    }
+}
+
 void game::debug_hour_timer::toggle()
 {
     enabled = !enabled;
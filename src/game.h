@@ -93,6 +93,7 @@ class spell_events;
 class static_popup;
 class stats_tracker;
 class timed_event_manager;
+class turn_profiler_ui;
 class ui_adaptor;
 class uilist;
 class vehicle;
@@ -1110,6 +1111,9 @@ class game
         void display_scent();   // Displays the scent map
         void display_visibility(); // Displays visibility map
         void display_lighting(); // Displays lighting conditions heat map
+        // live per-phase turn timings, shown while non-null
+        std::unique_ptr<turn_profiler_ui> turn_profiler_overlay; // NOLINT(cata-serialize)
+        void toggle_turn_profiler_overlay();
 
     private:
         // prints the IRL time in ms of the last full in-game hour
@@ -91,6 +91,7 @@
 #include "timed_event.h"
 #include "translation.h"
 #include "translations.h"
+#include "turn_replay.h"
 #include "ui_manager.h"
 #include "uilist.h"
 #include "uistate.h"
@@ -3193,9 +3194,12 @@ bool game::handle_action()
         std::swap( uistate.open_menu, open_menu_tmp );
         open_menu_tmp.value()();
         return false;
+    } else if( get_turn_replay().is_replaying() ) {
+        action = get_turn_replay().next_action();
     } else {
         // No auto-move, ask player for input
         ctxt = get_player_input( action );
+        get_turn_replay().record_action( action );
     }
 
     // Remove asynchronous animations if any action taken before the input timeout
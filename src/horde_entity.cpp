@@ -15,18 +15,23 @@ horde_entity::horde_entity( const monster &original )
         tracking_intensity = original.wandf;
     }
     moves = original.get_moves();
+    // Monsters only leave the reality bubble on the main thread, so this lookup can't race
+    // with the hordes moving in parallel.
     type_id = original.type->id.id();
     monster_data = std::make_unique<monster>( original );
 }
 
-horde_entity::horde_entity( const mtype_id &original )
+horde_entity::horde_entity( const mtype_id &original ) : type_id( original.id() )
+{
+}
+
+horde_entity::horde_entity( const mtype_int_id &original ) : type_id( original )
 {
-    type_id = original.id();
 }
 
 const mtype *horde_entity::get_type() const
 {
-    return type_id ? &type_id.obj() : monster_data->type;
+    return &type_id.obj();
 }
 
 bool horde_entity::is_active() const
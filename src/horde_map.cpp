@@ -1,10 +1,13 @@
 #include "horde_map.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
 #include <tuple>
 
+#include "cata_assert.h"
 #include "debug.h"
 #include "map_scale_constants.h"
 #include "monster.h"
@@ -13,113 +16,251 @@
 static const species_id species_FERAL( "FERAL" );
 static const species_id species_ZOMBIE( "ZOMBIE" );
 
-// Is just entity enough or do we need to wrap it in a tuple with a coordinate?
-// Or worse an iterator?
-horde_entity *horde_map::entity_at( const tripoint_om_ms &p )
-{
-    tripoint_om_sm submap_offset = project_to<coords::sm>( p );
-    // TODO reconsider pruning p down to tripoint_om_ms in the first place.
-    tripoint_abs_ms entity_loc = project_combine( location, p );
-    std::unordered_map<tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>>::iterator
-            active_monster_submap = active_monster_map.find( submap_offset );
-    bool active_map_exists = active_monster_submap != active_monster_map.end() &&
-                             !active_monster_submap->second.empty();
-    if( active_map_exists ) {
-        std::unordered_map<tripoint_abs_ms, horde_entity>::iterator iter =
-            active_monster_submap->second.find( entity_loc );
-        if( iter != active_monster_submap->second.end() ) {
-            return &iter->second;
-        }
+static uint8_t local_index( const point_sm_ms &p )
+{
+    return static_cast<uint8_t>( p.x() + p.y() * SEEX );
+}
+
+static int16_t pack_moves( int moves )
+{
+    // Entities that are stuck keep accumulating moves, saturate rather than wrap.
+    return static_cast<int16_t>( std::clamp<int>( moves, std::numeric_limits<int16_t>::min(),
+                                 std::numeric_limits<int16_t>::max() ) );
+}
+
+// horde_entity_ref definitions
+
+tripoint_abs_ms horde_entity_ref::pos() const
+{
+    const uint8_t local = chunk->entities[index].local;
+    return project_combine( chunk->origin, point_sm_ms( local % SEEX, local / SEEX ) );
+}
+
+mtype_int_id horde_entity_ref::type_id() const
+{
+    return chunk->entities[index].type_id;
+}
+
+const mtype *horde_entity_ref::get_type() const
+{
+    return &chunk->entities[index].type_id.obj();
+}
+
+bool horde_entity_ref::is_active() const
+{
+    return tracking_intensity() > 0;
+}
+
+tripoint_abs_ms horde_entity_ref::destination() const
+{
+    return chunk->keeps_goals ? chunk->goals[index].destination : tripoint_abs_ms();
+}
+
+int horde_entity_ref::tracking_intensity() const
+{
+    return chunk->keeps_goals ? chunk->goals[index].tracking_intensity : 0;
+}
+
+time_point horde_entity_ref::last_processed() const
+{
+    return chunk->keeps_goals ? chunk->goals[index].last_processed : time_point();
+}
+
+int horde_entity_ref::moves() const
+{
+    return chunk->entities[index].moves;
+}
+
+monster *horde_entity_ref::monster_data() const
+{
+    const uint8_t monster_index = chunk->entities[index].monster_index;
+    if( monster_index == horde_chunk::no_monster_data ) {
+        return nullptr;
     }
-    std::unordered_map<tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>>::iterator
-            idle_monster_submap = idle_monster_map.find( submap_offset );
-    bool idle_map_exists = idle_monster_submap != idle_monster_map.end() &&
-                           !idle_monster_submap->second.empty();
-    if( idle_map_exists ) {
-        std::unordered_map<tripoint_abs_ms, horde_entity>::iterator iter =
-            idle_monster_submap->second.find( entity_loc );
-        if( iter != idle_monster_submap->second.end() ) {
-            return &iter->second;
+    return chunk->monster_data[monster_index].get();
+}
+
+void horde_entity_ref::set_tracking_intensity( int intensity ) const
+{
+    cata_assert( chunk->keeps_goals );
+    chunk->goals[index].tracking_intensity = intensity;
+}
+
+void horde_entity_ref::set_last_processed( const time_point &turn ) const
+{
+    cata_assert( chunk->keeps_goals );
+    chunk->goals[index].last_processed = turn;
+}
+
+void horde_entity_ref::set_moves( int moves ) const
+{
+    chunk->entities[index].moves = pack_moves( moves );
+}
+
+// horde_chunk definitions
+
+std::optional<size_t> horde_chunk::find( uint8_t local ) const
+{
+    for( size_t i = 0; i < entities.size(); ++i ) {
+        if( entities[i].local == local ) {
+            return i;
         }
     }
-    std::unordered_map<tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>>::iterator
-            dormant_monster_submap = dormant_monster_map.find( submap_offset );
-    bool dormant_map_exists = dormant_monster_submap != dormant_monster_map.end() &&
-                              !dormant_monster_submap->second.empty();
-    if( dormant_map_exists ) {
-        std::unordered_map<tripoint_abs_ms, horde_entity>::iterator iter =
-            dormant_monster_submap->second.find( entity_loc );
-        if( iter != dormant_monster_submap->second.end() ) {
-            return  &iter->second;
+    return std::nullopt;
+}
+
+size_t horde_chunk::add( uint8_t local, horde_entity &&entity )
+{
+    horde_entity_record record;
+    record.type_id = entity.type_id;
+    record.moves = pack_moves( entity.moves );
+    record.local = local;
+    record.monster_index = no_monster_data;
+    if( entity.monster_data ) {
+        record.monster_index = static_cast<uint8_t>( monster_data.size() );
+        monster_data.emplace_back( std::move( entity.monster_data ) );
+    }
+    entities.push_back( record );
+    if( keeps_goals ) {
+        goals.push_back( horde_entity_goal{ entity.destination, entity.tracking_intensity,
+                                            entity.last_processed } );
+    }
+    return entities.size() - 1;
+}
+
+horde_entity horde_chunk::remove( size_t index )
+{
+    const horde_entity_record record = entities[index];
+    horde_entity entity( record.type_id );
+    entity.moves = record.moves;
+    if( keeps_goals ) {
+        entity.destination = goals[index].destination;
+        entity.tracking_intensity = goals[index].tracking_intensity;
+        entity.last_processed = goals[index].last_processed;
+        goals[index] = goals.back();
+        goals.pop_back();
+    }
+    if( record.monster_index != no_monster_data ) {
+        entity.monster_data = std::move( monster_data[record.monster_index] );
+        // Keep the side table dense, the entity owning the last slot takes the freed one.
+        const uint8_t last_slot = static_cast<uint8_t>( monster_data.size() - 1 );
+        if( record.monster_index != last_slot ) {
+            monster_data[record.monster_index] = std::move( monster_data.back() );
+            for( horde_entity_record &other : entities ) {
+                if( other.monster_index == last_slot ) {
+                    other.monster_index = record.monster_index;
+                    break;
+                }
+            }
         }
+        monster_data.pop_back();
+    }
+    entities[index] = entities.back();
+    entities.pop_back();
+    return entity;
+}
+
+// horde_map definitions
+
+horde_chunk &horde_map::chunk_at( map_type &target, const tripoint_om_sm &p )
+{
+    // Only entities in these maps have any use for a goal.
+    const bool keeps_goals = &target == &active_monster_map || &target == &dormant_monster_map;
+    return target.try_emplace( p, project_combine( location, p ), keeps_goals ).first->second;
+}
+
+std::optional<horde_entity_ref> horde_map::place( map_type &target, const tripoint_abs_ms &p,
+        horde_entity &&entity, bool &inserted )
+{
+    tripoint_abs_sm abs_sm;
+    point_sm_ms local;
+    std::tie( abs_sm, local ) = project_remain<coords::sm>( p );
+    point_abs_om omp;
+    tripoint_om_sm sm;
+    std::tie( omp, sm ) = project_remain<coords::om>( abs_sm );
+    horde_chunk &chunk = chunk_at( target, sm );
+    const uint8_t local_pos = local_index( local );
+    std::optional<size_t> existing = chunk.find( local_pos );
+    inserted = !existing;
+    if( existing ) {
+        return chunk[*existing];
     }
-    std::unordered_map<tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>>::iterator
-            immobile_monster_submap = immobile_monster_map.find( submap_offset );
-    bool immobile_map_exists = immobile_monster_submap != immobile_monster_map.end() &&
-                               !immobile_monster_submap->second.empty();
-    if( immobile_map_exists ) {
-        std::unordered_map<tripoint_abs_ms, horde_entity>::iterator iter =
-            immobile_monster_submap->second.find( entity_loc );
-        if( iter != immobile_monster_submap->second.end() ) {
-            return  &iter->second;
+    return chunk[chunk.add( local_pos, std::move( entity ) )];
+}
+
+// Is just entity enough or do we need to wrap it in a tuple with a coordinate?
+// Or worse an iterator?
+std::optional<horde_entity_ref> horde_map::entity_at( const tripoint_om_ms &p )
+{
+    tripoint_om_sm submap_offset;
+    point_sm_ms local;
+    std::tie( submap_offset, local ) = project_remain<coords::sm>( p );
+    const uint8_t local_pos = local_index( local );
+    for( map_type *target : {
+             &active_monster_map, &idle_monster_map, &dormant_monster_map, &immobile_monster_map
+         } ) {
+        map_type::iterator submap_iter = target->find( submap_offset );
+        if( submap_iter == target->end() ) {
+            continue;
+        }
+        std::optional<size_t> index = submap_iter->second.find( local_pos );
+        if( index ) {
+            return submap_iter->second[*index];
         }
     }
-    return nullptr;
+    return std::nullopt;
 }
 
 // TODO: if callers want to filter for dormant vs idle vs active, etc we can do it cheaply.
-std::vector < std::unordered_map<tripoint_abs_ms, horde_entity> *> horde_map::entity_group_at(
-    const tripoint_om_omt &p, int filter )
+std::vector<horde_chunk *> horde_map::entity_group_at( const tripoint_om_omt &p, int filter )
 {
     // TODO: It might be worthwhile to have a single top level map of per-submap containers,
     // and each entry of that map holds each variant container.
     // This eliminates multiple top-level lookups.
-    std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> horde_chunk;
+    std::vector<horde_chunk *> horde_chunks;
     // TODO: Find all 4 submaps worth of monsters and return them.
     for( int y = 0; y <= 1; ++y ) {
         for( int x = 0; x <= 1; ++x ) {
             tripoint_om_sm target_submap = project_to<coords::sm>( p ) + point{ x, y };
-            std::vector<std::unordered_map<tripoint_abs_ms, horde_entity> *> submap_of_hordes =
-                entity_group_at( target_submap, filter );
-            horde_chunk.insert( horde_chunk.end(), submap_of_hordes.begin(), submap_of_hordes.end() );
+            std::vector<horde_chunk *> submap_of_hordes = entity_group_at( target_submap, filter );
+            horde_chunks.insert( horde_chunks.end(), submap_of_hordes.begin(), submap_of_hordes.end() );
         }
     }
-    return horde_chunk;
+    return horde_chunks;
 }
 
-std::vector<std::unordered_map<tripoint_abs_ms, horde_entity> *> horde_map::entity_group_at(
-    const tripoint_om_sm &p, int filter )
+std::vector<horde_chunk *> horde_map::entity_group_at( const tripoint_om_sm &p, int filter )
 {
-    std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> horde_chunk;
+    std::vector<horde_chunk *> horde_chunks;
 
     if( filter & horde_map_flavors::active ) {
         auto active_monster_map_iter = active_monster_map.find( p );
         if( active_monster_map_iter != active_monster_map.end() ) {
-            horde_chunk.push_back( &active_monster_map_iter->second );
+            horde_chunks.push_back( &active_monster_map_iter->second );
         }
     }
 
     if( filter & horde_map_flavors::idle ) {
         auto idle_monster_map_iter = idle_monster_map.find( p );
         if( idle_monster_map_iter != idle_monster_map.end() ) {
-            horde_chunk.push_back( &idle_monster_map_iter->second );
+            horde_chunks.push_back( &idle_monster_map_iter->second );
         }
     }
 
     if( filter & horde_map_flavors::dormant ) {
         auto dormant_monster_map_iter = dormant_monster_map.find( p );
         if( dormant_monster_map_iter != dormant_monster_map.end() ) {
-            horde_chunk.push_back( &dormant_monster_map_iter->second );
+            horde_chunks.push_back( &dormant_monster_map_iter->second );
         }
     }
 
     if( filter & horde_map_flavors::immobile ) {
         auto immobile_monster_map_iter = immobile_monster_map.find( p );
         if( immobile_monster_map_iter != immobile_monster_map.end() ) {
-            horde_chunk.push_back( &immobile_monster_map_iter->second );
+            horde_chunks.push_back( &immobile_monster_map_iter->second );
         }
     }
-    return horde_chunk;
+    return horde_chunks;
 }
 
 // Helper because this is too much to inline.
@@ -130,122 +271,145 @@ static bool is_alert( const mtype &type )
     return aggro && type.has_flag( mon_flag_HEARS );
 }
 
+horde_map::map_type &horde_map::target_map( const mtype &type, bool active )
+{
+    return type.has_flag( mon_flag_DORMANT ) ? dormant_monster_map :
+           !is_alert( type ) ? immobile_monster_map :
+           active ? active_monster_map :
+           idle_monster_map;
+}
+
 // These have no goal so they can't go in the active map.
-std::optional<std::unordered_map<tripoint_abs_ms, horde_entity>::iterator> horde_map::spawn_entity(
-    const tripoint_abs_ms &p, mtype_id id )
+std::optional<horde_entity_ref> horde_map::spawn_entity( const tripoint_abs_ms &p, mtype_id id )
 {
-    std::optional<std::unordered_map<tripoint_abs_ms, horde_entity>::iterator> result;
     if( id.is_null() || !id.is_valid() ) {
-        return result; // Bail out, blacklisted monster or something's wrong.
+        return std::nullopt; // Bail out, blacklisted monster or something's wrong.
     }
-    std::unordered_map <tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>> &target_map =
-                id->has_flag( mon_flag_DORMANT ) ? dormant_monster_map :
-                is_alert( *id ) ? idle_monster_map :
-                immobile_monster_map;
-    point_abs_om omp;
-    tripoint_om_sm sm;
-    std::tie( omp, sm ) = project_remain<coords::om>( project_to<coords::sm>( p ) );
     bool inserted;
-    // The [] operator creates a nested std::map if not present already.
-    std::tie( result, inserted ) = target_map[sm].emplace( p, id );
-    return result;
+    return place( target_map( *id, false ), p, horde_entity( id ), inserted );
 }
 
-// TODO: check for a goal in horde_entity and put in active vs idle.
-std::optional<std::unordered_map<tripoint_abs_ms, horde_entity>::iterator> horde_map::spawn_entity(
-    const tripoint_abs_ms &p, const monster &mon )
+std::optional<horde_entity_ref> horde_map::spawn_entity( const tripoint_abs_ms &p,
+        const monster &mon )
 {
-    std::unordered_map <tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>> &target_map =
-                mon.type->has_flag( mon_flag_DORMANT ) ? dormant_monster_map :
-                !is_alert( *mon.type ) ? immobile_monster_map :
-                ( mon.has_dest() || mon.wandf > 0 ) ? active_monster_map :
-                idle_monster_map;
-    std::optional<std::unordered_map<tripoint_abs_ms, horde_entity>::iterator> result;
-    point_abs_om omp;
-    tripoint_om_sm sm;
-    std::tie( omp, sm ) = project_remain<coords::om>( project_to<coords::sm>( p ) );
+    horde_entity entity( mon );
+    map_type &target = target_map( *mon.type, entity.is_active() );
     bool inserted;
-    // The [] operator creates a nested std::map if not present already.
-    std::tie( result, inserted ) = target_map[sm].emplace( p, mon );
+    std::optional<horde_entity_ref> result = place( target, p, std::move( entity ), inserted );
     if( inserted ) {
-        ( *result )->second.monster_data->set_pos_abs_only( p );
+        result->monster_data()->set_pos_abs_only( p );
     } else {
         debugmsg( "Attempted to insert a %s at %s, but there's already a %s there!",
-                  mon.name(), p.to_string(), ( *result )->second.get_type()->nname() );
+                  mon.name(), p.to_string(), result->get_type()->nname() );
     }
     return result;
 }
 
-static void signal_sm( const tripoint_abs_ms &origin, const tripoint_abs_sm &sm_dest,
-                       const tripoint_abs_sm &sm_origin, int volume,
-                       std::unordered_map <tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>>::iterator
-                       &sm_iter, bool active, std::unordered_map<tripoint_abs_ms, horde_entity> &migrating_hordes )
+// Volume is scaled down by SEEX so it matches the scale of tripoint_om_sm
+static int signal_power( const tripoint_abs_sm &sm_dest, const tripoint_abs_sm &sm_origin,
+                         int volume )
 {
-
     const int dist = rl_dist( sm_dest, sm_origin );
-    int eff_power = volume - dist;
-    if( eff_power <= 0 ) {
-        return;
-    }
-    int scaled_eff_power = eff_power * SEEX;
-    for( std::unordered_map<tripoint_abs_ms, horde_entity>::iterator mon = sm_iter->second.begin();
-         mon != sm_iter->second.end(); ) {
-        // Avoid unecessary extract/insert for already-active horde entities.
-        if( !active ) {
-            mon->second.destination = origin;
-            mon->second.tracking_intensity = scaled_eff_power;
-            std::unordered_map<tripoint_abs_ms, horde_entity>::iterator moving_mon = mon;
-            // Advance the loop iterator past the current node, which we will be removing.
-            mon++;
-            auto monster_node = sm_iter->second.extract( moving_mon );
-            migrating_hordes.insert( std::move( monster_node ) );
-        } else {
-            if( mon->second.tracking_intensity < scaled_eff_power ) {
-                mon->second.destination = origin;
-                mon->second.tracking_intensity = scaled_eff_power;
-            }
-            ++mon;
-        }
-    }
+    return ( volume - dist ) * SEEX;
 }
 
-// Volume is scaled down by SEEX so it matches the scale of tripoint_om_sm
 // dormant_monster_map and immobile_monster_map are intentionally excluded here.
 void horde_map::signal_entities( const tripoint_abs_ms &origin, int volume )
 {
-    std::unordered_map<tripoint_abs_ms, horde_entity> migrating_hordes;
     tripoint_abs_sm sm_dest = project_to<coords::sm>( origin );
-    for( std::unordered_map
-         <tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>>::iterator active_sm_iter =
-             active_monster_map.begin(); active_sm_iter != active_monster_map.end(); ++active_sm_iter ) {
-        tripoint_abs_sm abs_sm = project_combine( location, active_sm_iter->first );
-        signal_sm( origin, sm_dest, abs_sm, volume, active_sm_iter, true, migrating_hordes );
+    for( std::pair<const tripoint_om_sm, horde_chunk> &active_sm : active_monster_map ) {
+        const int scaled_eff_power = signal_power( sm_dest, active_sm.second.origin, volume );
+        if( scaled_eff_power <= 0 ) {
+            continue;
+        }
+        for( horde_entity_goal &goal : active_sm.second.goals ) {
+            if( goal.tracking_intensity <= 0 ) {
+                // Don't let a long idle entity catch up on the time it had nowhere to go.
+                goal.last_processed = std::max( goal.last_processed, calendar::turn - 1_turns );
+            }
+            if( goal.tracking_intensity < scaled_eff_power ) {
+                goal.destination = origin;
+                goal.tracking_intensity = scaled_eff_power;
+            }
+        }
     }
-    for( std::unordered_map
-         <tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>>::iterator idle_sm_iter =
-             idle_monster_map.begin(); idle_sm_iter != idle_monster_map.end(); ++idle_sm_iter ) {
-        tripoint_abs_sm abs_sm = project_combine( location, idle_sm_iter->first );
-        signal_sm( origin, sm_dest, abs_sm, volume, idle_sm_iter, false, migrating_hordes );
+    // Every idle entity in a submap gets the same goal, so move them over all at once.
+    for( map_type::iterator idle_sm_iter = idle_monster_map.begin();
+         idle_sm_iter != idle_monster_map.end(); ) {
+        horde_chunk &idle_chunk = idle_sm_iter->second;
+        const int scaled_eff_power = signal_power( sm_dest, idle_chunk.origin, volume );
+        if( scaled_eff_power <= 0 ) {
+            ++idle_sm_iter;
+            continue;
+        }
+        horde_chunk &active_chunk = chunk_at( active_monster_map, idle_sm_iter->first );
+        while( !idle_chunk.empty() ) {
+            const uint8_t local = idle_chunk.entities.back().local;
+            horde_entity entity = idle_chunk.remove( idle_chunk.size() - 1 );
+            entity.destination = origin;
+            entity.tracking_intensity = scaled_eff_power;
+            entity.last_processed = calendar::turn - 1_turns;
+            if( !active_chunk.find( local ) ) {
+                active_chunk.add( local, std::move( entity ) );
+            }
+        }
+        idle_sm_iter = idle_monster_map.erase( idle_sm_iter );
     }
+}
 
-    while( !migrating_hordes.empty() ) {
-        auto monster_node = migrating_hordes.extract( migrating_hordes.begin() );
-        insert( std::move( monster_node ) );
+void horde_map::insert( const tripoint_abs_ms &p, horde_entity &&entity )
+{
+    map_type &target = target_map( *entity.get_type(), entity.is_active() );
+    bool inserted;
+    place( target, p, std::move( entity ), inserted );
+}
+
+std::vector<tripoint_om_sm> horde_map::active_submaps() const
+{
+    std::vector<tripoint_om_sm> submaps;
+    submaps.reserve( active_monster_map.size() );
+    for( const std::pair<const tripoint_om_sm, horde_chunk> &active_sm : active_monster_map ) {
+        submaps.push_back( active_sm.first );
     }
+    return submaps;
 }
 
-void horde_map::insert( std::unordered_map<tripoint_abs_ms, horde_entity>::node_type &&node )
+horde_chunk *horde_map::active_chunk( const tripoint_om_sm &p )
 {
-    std::unordered_map <tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>> &target_map =
-                node.mapped().get_type()->has_flag( mon_flag_DORMANT ) ? dormant_monster_map :
-                node.mapped().is_active() ? active_monster_map :
-                is_alert( *node.mapped().get_type() ) ? idle_monster_map :
-                immobile_monster_map;
-    point_abs_om omp;
-    tripoint_om_sm sm;
-    std::tie( omp, sm ) = project_remain<coords::om>( project_to<coords::sm> ( node.key() ) );
-    // The [] operator creates a nested std::map if not present already.
-    target_map[sm].insert( std::move( node ) );
+    map_type::iterator active_sm_iter = active_monster_map.find( p );
+    return active_sm_iter == active_monster_map.end() ? nullptr : &active_sm_iter->second;
+}
+
+horde_entity horde_map::extract( horde_chunk &chunk, size_t index )
+{
+    return chunk.remove( index );
+}
+
+void horde_map::prune_chunk( const tripoint_om_sm &p )
+{
+    for( map_type *target : {
+             &active_monster_map, &idle_monster_map, &dormant_monster_map, &immobile_monster_map
+         } ) {
+        map_type::iterator submap_iter = target->find( p );
+        if( submap_iter != target->end() && submap_iter->second.empty() ) {
+            target->erase( submap_iter );
+        }
+    }
+}
+
+std::vector<std::pair<tripoint_abs_ms, horde_entity>> horde_map::extract_chunk(
+            const tripoint_om_sm &p )
+{
+    std::vector<std::pair<tripoint_abs_ms, horde_entity>> extracted;
+    for( horde_chunk *chunk : entity_group_at( p ) ) {
+        while( !chunk->empty() ) {
+            const size_t last = chunk->size() - 1;
+            const tripoint_abs_ms entity_pos = ( *chunk )[last].pos();
+            extracted.emplace_back( entity_pos, chunk->remove( last ) );
+        }
+    }
+    clear_chunk( p );
+    return extracted;
 }
 
 void horde_map::clear()
@@ -312,18 +476,18 @@ void horde_map::iterator::insure_valid()
         outer_iter = outer_map->begin();
     }
     // This is not obviously correct, but it is correct because
-    // horde_map::erase() insures that we cull empty maps, so if
+    // horde_map::erase() insures that we cull empty chunks, so if
     // outer_map is not empty, outer_map->begin() is valid and so is
-    // outer_map->begin()->second.begin()
-    inner_iter = outer_iter->second.begin();
+    // the first entity of outer_map->begin()->second.
+    index = 0;
 }
 
 horde_map::iterator &horde_map::iterator::operator++()
 {
-    if( inner_iter != outer_iter->second.end() ) {
-        ++inner_iter;
+    if( index < outer_iter->second.size() ) {
+        ++index;
     }
-    while( inner_iter == outer_iter->second.end() ) {
+    while( index >= outer_iter->second.size() ) {
         ++outer_iter;
         while( outer_iter == outer_map->end() ) {
             next_map();
@@ -332,7 +496,7 @@ horde_map::iterator &horde_map::iterator::operator++()
             }
             outer_iter = outer_map->begin();
         }
-        inner_iter = outer_iter->second.begin();
+        index = 0;
     }
     return *this;
 }
@@ -348,7 +512,7 @@ bool horde_map::iterator::operator==( iterator other ) const
 {
     return ( outer_map == nullptr && other.outer_map == nullptr ) ||
            ( outer_map == other.outer_map && outer_iter == other.outer_iter &&
-             inner_iter == other.inner_iter );
+             index == other.index );
 }
 
 bool horde_map::iterator::operator!=( iterator other ) const
@@ -358,40 +522,30 @@ bool horde_map::iterator::operator!=( iterator other ) const
 
 horde_map::iterator::reference horde_map::iterator::operator*() const
 {
-    return *inner_iter;
+    return horde_entity_ref( &outer_iter->second, index );
 }
 
-horde_map::iterator::pointer horde_map::iterator::operator->() const
+horde_map::iterator::arrow_proxy horde_map::iterator::operator->() const
 {
-    return &*inner_iter;
+    return arrow_proxy{ **this };
 }
 
 horde_map::iterator horde_map::find( const tripoint_om_ms &loc )
 {
-    tripoint_om_sm submap_loc = project_to<coords::sm>( loc );
-    tripoint_abs_ms monster_loc = project_combine( location, loc );
-    map_type::iterator submap_iter = active_monster_map.find( submap_loc );
-    if( submap_iter != active_monster_map.end() ) {
-        std::unordered_map<tripoint_abs_ms, horde_entity>::iterator mon_iter =
-            submap_iter->second.find( monster_loc );
-        if( mon_iter != submap_iter->second.end() ) {
-            return iterator( *this, active_monster_map, submap_iter, mon_iter );
+    tripoint_om_sm submap_loc;
+    point_sm_ms local;
+    std::tie( submap_loc, local ) = project_remain<coords::sm>( loc );
+    const uint8_t local_pos = local_index( local );
+    for( map_type *target : {
+             &active_monster_map, &idle_monster_map, &dormant_monster_map
+         } ) {
+        map_type::iterator submap_iter = target->find( submap_loc );
+        if( submap_iter == target->end() ) {
+            continue;
         }
-    }
-    submap_iter = idle_monster_map.find( submap_loc );
-    if( submap_iter != idle_monster_map.end() ) {
-        std::unordered_map<tripoint_abs_ms, horde_entity>::iterator mon_iter =
-            submap_iter->second.find( monster_loc );
-        if( mon_iter != submap_iter->second.end() ) {
-            return iterator( *this, idle_monster_map, submap_iter, mon_iter );
-        }
-    }
-    submap_iter = dormant_monster_map.find( submap_loc );
-    if( submap_iter != dormant_monster_map.end() ) {
-        std::unordered_map<tripoint_abs_ms, horde_entity>::iterator mon_iter =
-            submap_iter->second.find( monster_loc );
-        if( mon_iter != submap_iter->second.end() ) {
-            return iterator( *this, dormant_monster_map, submap_iter, mon_iter );
+        std::optional<size_t> index = submap_iter->second.find( local_pos );
+        if( index ) {
+            return iterator( *this, *target, submap_iter, *index );
         }
     }
     return end();
@@ -399,23 +553,22 @@ horde_map::iterator horde_map::find( const tripoint_om_ms &loc )
 
 horde_map::iterator horde_map::erase( iterator iter )
 {
-    iterator old_iter = iter;
-    iter.inner_iter =
-        iter.outer_iter->second.erase( iter.inner_iter );
-    if( iter.inner_iter == iter.outer_iter->second.end() ) {
-        ++iter;
-        if( old_iter.outer_iter->second.empty() ) {
-            old_iter.outer_map->erase( old_iter.outer_iter );
-        }
-    }
+    extract( iter );
     return iter;
 }
 
-horde_map::node_type horde_map::extract( iterator iter )
+horde_entity horde_map::extract( iterator &iter )
 {
-    node_type node = iter.outer_iter->second.extract( iter.inner_iter );
-    if( iter.outer_iter->second.empty() ) {
-        iter.outer_map->erase( iter.outer_iter );
+    iterator old_iter = iter;
+    horde_chunk &chunk = iter.outer_iter->second;
+    horde_entity entity = chunk.remove( iter.index );
+    // Unless it was the last one, the last entity was swapped into the removed slot
+    // and iter already points at it.
+    if( iter.index >= chunk.size() ) {
+        ++iter;
+        if( chunk.empty() ) {
+            old_iter.outer_map->erase( old_iter.outer_iter );
+        }
     }
-    return node;
+    return entity;
 }
@@ -2,12 +2,16 @@
 #ifndef CATA_SRC_HORDE_MAP_H
 #define CATA_SRC_HORDE_MAP_H
 
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <memory>
 #include <optional>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "calendar.h"
 #include "coordinates.h"
 #include "horde_entity.h"
 #include "point.h"
@@ -24,13 +28,128 @@ enum {
 };
 } // namespace horde_map_flavors
 
+class horde_chunk;
+class horde_map;
 class monster;
 
-// As this class holds a large number of entries (many thousands per overmap),
-// there are a number of optimizations that are worth investigating.
-// One is minimizing the sizes of the keys.  The outer key could be tripoint_om_sm<byte>
-// and the inner key could be a point_omt_ms<byte>, shrinking their memory footprint from
-// 12 bytes each to 3 and two bytes each respectively.
+/**
+ * A reference to an entity stored in a horde_map.
+ * It is invalidated by anything that adds or removes entities from the same submap.
+ */
+class horde_entity_ref
+{
+        horde_chunk *chunk;
+        size_t index;
+    public:
+        horde_entity_ref( horde_chunk *c, size_t i ) : chunk( c ), index( i ) {}
+
+        tripoint_abs_ms pos() const;
+        mtype_int_id type_id() const;
+        const mtype *get_type() const;
+        bool is_active() const;
+        // Entities in submaps that don't keep goals have no destination or tracking intensity.
+        tripoint_abs_ms destination() const;
+        int tracking_intensity() const;
+        time_point last_processed() const;
+        int moves() const;
+        // Null for entities that were never spawned.
+        monster *monster_data() const;
+
+        // These can only be called on entities whose submap keeps goals.
+        void set_tracking_intensity( int intensity ) const;
+        void set_last_processed( const time_point &turn ) const;
+        void set_moves( int moves ) const;
+};
+
+// Packed form of a horde_entity, its location is stored relative to its submap.
+struct horde_entity_record {
+    mtype_int_id type_id;
+    int16_t moves = 0;
+    // x + y * SEEX within the submap.
+    uint8_t local = 0;
+    // Index into horde_chunk::monster_data, or horde_chunk::no_monster_data.
+    uint8_t monster_index = 0;
+};
+static_assert( sizeof( horde_entity_record ) == 8, "horde_entity_record should stay packed" );
+
+// The part of a horde_entity that is only needed while it has somewhere to go.
+struct horde_entity_goal {
+    tripoint_abs_ms destination;
+    int tracking_intensity = 0;
+    time_point last_processed;
+};
+
+/**
+ * All of the entities of one flavor in a single submap.
+ * The per-entity data is kept in parallel arrays indexed the same way: a small fixed size
+ * record for every entity, goals only for the flavors that move, and the rare spawned
+ * monsters in a side table.  There can't be more than SEEX * SEEY entities in a submap,
+ * so all of the indices fit in a byte.
+ * Removal swaps the last entity into the removed slot, so the order is unspecified.
+ */
+class horde_chunk
+{
+    public:
+        static constexpr uint8_t no_monster_data = UINT8_MAX;
+
+        horde_chunk( const tripoint_abs_sm &chunk_origin, bool chunk_keeps_goals ) :
+            origin( chunk_origin ), keeps_goals( chunk_keeps_goals ) {}
+
+        size_t size() const {
+            return entities.size();
+        }
+        bool empty() const {
+            return entities.empty();
+        }
+        horde_entity_ref operator[]( size_t index ) {
+            return horde_entity_ref( this, index );
+        }
+
+        class iterator
+        {
+                horde_chunk *chunk;
+                size_t index;
+            public:
+                iterator( horde_chunk *c, size_t i ) : chunk( c ), index( i ) {}
+                horde_entity_ref operator*() const {
+                    return horde_entity_ref( chunk, index );
+                }
+                iterator &operator++() {
+                    ++index;
+                    return *this;
+                }
+                bool operator==( const iterator &other ) const {
+                    return index == other.index;
+                }
+                bool operator!=( const iterator &other ) const {
+                    return index != other.index;
+                }
+        };
+        iterator begin() {
+            return iterator( this, 0 );
+        }
+        iterator end() {
+            return iterator( this, entities.size() );
+        }
+
+    private:
+        friend class horde_entity_ref;
+        friend class horde_map;
+
+        std::optional<size_t> find( uint8_t local ) const;
+        size_t add( uint8_t local, horde_entity &&entity );
+        horde_entity remove( size_t index );
+
+        tripoint_abs_sm origin;
+        bool keeps_goals;
+        std::vector<horde_entity_record> entities;
+        // Parallel to entities when keeps_goals is set, empty otherwise.
+        std::vector<horde_entity_goal> goals;
+        std::vector<std::unique_ptr<monster>> monster_data;
+};
+
+// Entities are stored per submap in packed horde_chunk containers, which keeps them at
+// around 8 bytes each for the common case of a never spawned entity without a goal.
 /**
  * horde_map handles one overmap worth of monster entities.
  * The primary divisions are location and different behavior,
@@ -38,8 +157,7 @@ class monster;
  */
 class horde_map
 {
-        using map_type = std::unordered_map
-                         <tripoint_om_sm, std::unordered_map<tripoint_abs_ms, horde_entity>>;
+        using map_type = std::unordered_map<tripoint_om_sm, horde_chunk>;
 
         map_type active_monster_map;
         // Monsters with the DORMANT flag get placed in this parallell structure that is
@@ -49,46 +167,61 @@ class horde_map
         map_type immobile_monster_map;
         point_abs_om location;
 
+        map_type &target_map( const mtype &type, bool active );
+        horde_chunk &chunk_at( map_type &target, const tripoint_om_sm &p );
+        std::optional<horde_entity_ref> place( map_type &target, const tripoint_abs_ms &p,
+                                               horde_entity &&entity, bool &inserted );
+
     public:
-        using node_type = std::unordered_map<tripoint_abs_ms, horde_entity>::node_type;
         void set_location( point_abs_om loc ) {
             location = loc;
         }
         point_abs_om get_location() {
             return location;
         }
-        horde_entity *entity_at( const tripoint_om_ms &p );
-        std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> entity_group_at(
+        std::optional<horde_entity_ref> entity_at( const tripoint_om_ms &p );
+        std::vector<horde_chunk *> entity_group_at(
             const tripoint_om_omt &p, int filter = horde_map_flavors::active | horde_map_flavors::idle |
                     horde_map_flavors::dormant | horde_map_flavors::immobile );
-        std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> entity_group_at(
+        std::vector<horde_chunk *> entity_group_at(
             const tripoint_om_sm &p, int filter = horde_map_flavors::active | horde_map_flavors::idle |
                     horde_map_flavors::dormant | horde_map_flavors::immobile );
-        std::optional<std::unordered_map<tripoint_abs_ms, horde_entity>::iterator>
-        spawn_entity( const tripoint_abs_ms &p, mtype_id id );
-        std::optional<std::unordered_map<tripoint_abs_ms, horde_entity>::iterator> spawn_entity(
-            const tripoint_abs_ms &p,
-            const monster &mon );
+        std::optional<horde_entity_ref> spawn_entity( const tripoint_abs_ms &p, mtype_id id );
+        std::optional<horde_entity_ref> spawn_entity( const tripoint_abs_ms &p, const monster &mon );
         void signal_entities( const tripoint_abs_ms &origin, int volume );
-        void insert( node_type &&node );
+        void insert( const tripoint_abs_ms &p, horde_entity &&entity );
+        // Submaps holding active entities, for processing them a submap at a time.
+        std::vector<tripoint_om_sm> active_submaps() const;
+        horde_chunk *active_chunk( const tripoint_om_sm &p );
+        // Removes an entity from a chunk of this map, the last entity of the chunk takes its index.
+        // The chunk is kept even if it is left empty, prune_chunk() has to be called afterwards.
+        horde_entity extract( horde_chunk &chunk, size_t index );
+        void prune_chunk( const tripoint_om_sm &p );
+        // Removes every entity in the submap and returns them, in the same order as entity_group_at.
+        std::vector<std::pair<tripoint_abs_ms, horde_entity>> extract_chunk( const tripoint_om_sm &p );
         void clear();
         void clear_chunk( const tripoint_om_sm &p );
 
         class iterator
         {
                 using iterator_category = std::forward_iterator_tag;
-                using value_type = std::pair<const tripoint_abs_ms, horde_entity>;
+                using value_type = horde_entity_ref;
                 using difference_type = int;
-                using pointer = std::pair<const tripoint_abs_ms, horde_entity> *;
-                using reference = std::pair<const tripoint_abs_ms, horde_entity> &;
+                using reference = horde_entity_ref;
                 horde_map *parent = nullptr;
                 map_type *outer_map = nullptr;
                 map_type::iterator outer_iter;
-                std::unordered_map<tripoint_abs_ms, horde_entity>::iterator inner_iter;
+                size_t index = 0;
                 int filter = horde_map_flavors::active | horde_map_flavors::idle | horde_map_flavors::dormant |
                              horde_map_flavors::immobile;
             public:
                 friend horde_map;
+                struct arrow_proxy {
+                    horde_entity_ref ref;
+                    const horde_entity_ref *operator->() const {
+                        return &ref;
+                    }
+                };
                 // TODO: ideally these would be private, no use case for constructing them outside of horde_map
                 // No args gets you the end() iterator.
                 explicit iterator() = default;
@@ -105,9 +238,8 @@ class horde_map
                 }
                 // Sets the members directly. TODO: make private but accessable to horde_map
                 explicit iterator( const horde_map &p, map_type &m, map_type::iterator oi,
-                                   std::unordered_map<tripoint_abs_ms, horde_entity>::iterator ii ) : parent( const_cast<horde_map *>
-                                               ( &p ) ), outer_map( &m ),
-                    outer_iter( oi ), inner_iter( ii ) {}
+                                   size_t i ) : parent( const_cast<horde_map *>( &p ) ), outer_map( &m ),
+                    outer_iter( oi ), index( i ) {}
                 void next_map();
                 void insure_valid();
                 iterator &operator++();
@@ -115,7 +247,7 @@ class horde_map
                 bool operator==( iterator other ) const;
                 bool operator!=( iterator other ) const;
                 reference operator*() const;
-                pointer operator->() const;
+                arrow_proxy operator->() const;
         };
         iterator begin() const {
             return iterator( *this );
@@ -131,7 +263,8 @@ class horde_map
         }
         iterator find( const tripoint_om_ms &loc );
         iterator erase( iterator iter );
-        node_type extract( iterator iter );
+        // Removes the entity and advances iter to the next one, like erase().
+        horde_entity extract( iterator &iter );
 
         class view_proxy
         {
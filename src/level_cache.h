@@ -4,15 +4,18 @@
 
 #include <array>
 #include <bitset>
+#include <cstddef>
 #include <set>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "coordinates.h"
 #include "lightmap.h"
 #include "map_scale_constants.h"
 #include "mdarray.h"
 #include "shadowcasting.h"
+#include "units.h"
 
 // IWYU pragma: no_forward_declare four_quadrants
 class vehicle;
@@ -105,4 +108,48 @@ struct level_cache {
         std::bitset<MAPSIZE_X *MAPSIZE_Y> veh_exists_at;
         std::unordered_map<tripoint_bub_ms, std::pair<vehicle *, int>> veh_cached_parts;
 };
+
+// A light source found by map::gather_light_sources(), as recorded before casting any light.
+struct recorded_light_source {
+    enum class kind : int {
+        point,      // map::apply_light_source
+        buffered,   // map::add_light_source
+        arc,        // map::apply_light_arc
+    };
+    kind type = kind::point;
+    tripoint_bub_ms p;
+    float luminance = 0.0f;
+    units::angle direction = 0_degrees;
+    units::angle width = 0_degrees;
+    light_color_rgb color;
+
+    bool operator==( const recorded_light_source &rhs ) const;
+};
+
+// Everything map::generate_lightmap() builds a lightmap from, besides the caches of what
+// blocks light.  A lightmap built from equal inputs would come out the same.
+struct lightmap_inputs {
+    int zlev = 0;
+    int avatar_z = 0;
+    int max_populated_z = 0;
+    std::array<float, OVERMAP_LAYERS> natural_light = {};
+    // The first character_sources of these are the lights carried by characters
+    std::vector<recorded_light_source> sources;
+    size_t character_sources = 0;
+    std::vector<std::pair<tripoint_bub_ms, float>> overrides;
+
+    bool operator==( const lightmap_inputs &rhs ) const;
+};
+
+// The light of the sources that rarely change (terrain, furniture and items lying around) on
+// one level, kept between lightmaps and merged into each of them.  See map::bake_static_light().
+struct baked_static_light {
+    int zlev = 0;
+    std::vector<recorded_light_source> sources;
+    // Submaps whose transparency was rebuilt since the light was baked
+    std::bitset<MAPSIZE *MAPSIZE> blockers_changed;
+    cata::mdarray<four_quadrants, point_bub_ms> lm;
+    cata::mdarray<float, point_bub_ms> sm;
+    cata::mdarray<light_color_rgb, point_bub_ms> light_color;
+};
 #endif // CATA_SRC_LEVEL_CACHE_H
@@ -1,6 +1,7 @@
 #include "lightmap.h" // IWYU pragma: associated
 #include "shadowcasting.h" // IWYU pragma: associated
 
+#include <algorithm>
 #include <bitset>
 #include <cmath>
 #include <cstdlib>
@@ -37,6 +38,7 @@
 #include "point.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "type_id.h"
 #include "units.h"
@@ -108,6 +110,10 @@ bool map::build_transparency_cache( const int zlev )
     if( map_cache.transparency_cache_dirty.none() ) {
         return false;
     }
+    lightmap_blockers_changed = true;
+    if( static_light && static_light->zlev == zlev ) {
+        static_light->blockers_changed |= map_cache.transparency_cache_dirty;
+    }
 
     // if true, all submaps are invalid (can use batch init)
     bool rebuild_all = map_cache.transparency_cache_dirty.all();
@@ -298,7 +304,20 @@ void map::apply_character_light( Character &p )
         apply_light_source( p.pos_bub(), held_luminance );
     }
 
-    if( held_luminance >= 4 && held_luminance > ambient_light_at( p.pos_bub() ) - 0.5f ) {
+    // While the sources are being gathered nothing is cast yet, so the light this character
+    // stands in is that of the sources recorded on their square.
+    float ambient = 0.0f;
+    if( recorded_light_sources != nullptr ) {
+        for( const recorded_light_source &src : *recorded_light_sources ) {
+            if( src.type == recorded_light_source::kind::point && src.p == p.pos_bub() ) {
+                ambient = std::max( { ambient, static_cast<float>( lit_level::LOW ),
+                                      src.luminance } );
+            }
+        }
+    } else {
+        ambient = ambient_light_at( p.pos_bub() );
+    }
+    if( held_luminance >= 4 && held_luminance > ambient - 0.5f ) {
         p.add_effect( effect_haslight, 1_turns );
     }
 }
@@ -397,98 +416,121 @@ void map::build_sunlight_cache( int pzlev )
             }
         };
 
-        fully_inside = true; // recalculate
-
-        // Fall back to minimal light level if we don't find anything.
-        std::fill_n( &lm[0][0], MAPSIZE_X * MAPSIZE_Y, four_quadrants( inside_light_level ) );
-
-        for( int x = 0; x < MAPSIZE_X; ++x ) {
-            for( int y = 0; y < MAPSIZE_Y; ++y ) {
-                // Check center, then four adjacent cardinals.
-                for( int i = 0; i < 5; ++i ) {
-                    point prev( cardinals[i] + point( x, y ) );
-                    bool inbounds = prev.x >= 0 && prev.x < MAPSIZE_X &&
-                                    prev.y >= 0 && prev.y < MAPSIZE_Y;
-
-                    if( !inbounds ) {
-                        continue;
-                    }
-
-                    float prev_light_max;
-                    float prev_transparency = prev_transparency_cache[prev.x][prev.y];
-                    // This is pretty gross, this cancels out the per-tile transparency effect
-                    // derived from weather.
-                    if( outside_cache[x][y] ) {
-                        prev_transparency /= sight_penalty;
-                    }
+        // Each level only reads the one above, so its columns can be split between threads.
+        thread_pool &pool = get_thread_pool();
+        const size_t chunks = pool.worker_count() + 1;
+        // Not std::vector<bool>, the chunks set their flags concurrently.
+        std::vector<char> chunk_fully_inside( chunks, true );
+        pool.parallel_for( chunks, [&]( size_t chunk ) {
+            const int x_begin = static_cast<int>( MAPSIZE_X * chunk / chunks );
+            const int x_end = static_cast<int>( MAPSIZE_X * ( chunk + 1 ) / chunks );
+            bool inside = true;
+
+            // Fall back to minimal light level if we don't find anything.
+            std::fill_n( &lm[x_begin][0], ( x_end - x_begin ) * MAPSIZE_Y,
+                         four_quadrants( inside_light_level ) );
+
+            for( int x = x_begin; x < x_end; ++x ) {
+                for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                    // Check center, then four adjacent cardinals.
+                    for( int i = 0; i < 5; ++i ) {
+                        point prev( cardinals[i] + point( x, y ) );
+                        bool inbounds = prev.x >= 0 && prev.x < MAPSIZE_X &&
+                                        prev.y >= 0 && prev.y < MAPSIZE_Y;
+
+                        if( !inbounds ) {
+                            continue;
+                        }
 
-                    if( prev_transparency > LIGHT_TRANSPARENCY_SOLID &&
-                        !prev_floor_cache[prev.x][prev.y] &&
-                        ( prev_light_max = prev_lm[prev.x][prev.y].max() ) > 0.0 ) {
-                        const float light_level = clamp( prev_light_max * LIGHT_TRANSPARENCY_OPEN_AIR / prev_transparency,
-                                                         inside_light_level, prev_light_max );
+                        float prev_light_max;
+                        float prev_transparency = prev_transparency_cache[prev.x][prev.y];
+                        // This is pretty gross, this cancels out the per-tile transparency effect
+                        // derived from weather.
+                        if( outside_cache[x][y] ) {
+                            prev_transparency /= sight_penalty;
+                        }
 
-                        if( i == 0 ) {
-                            lm[x][y].fill( light_level );
-                            fully_inside &= light_level <= inside_light_level;
-                            break;
-                        } else {
-                            fully_inside &= light_level <= inside_light_level;
-                            lm[x][y][dir_quadrants[i][0]] = light_level;
-                            lm[x][y][dir_quadrants[i][1]] = light_level;
+                        if( prev_transparency > LIGHT_TRANSPARENCY_SOLID &&
+                            !prev_floor_cache[prev.x][prev.y] &&
+                            ( prev_light_max = prev_lm[prev.x][prev.y].max() ) > 0.0 ) {
+                            const float light_level = clamp( prev_light_max * LIGHT_TRANSPARENCY_OPEN_AIR /
+                                                             prev_transparency, inside_light_level, prev_light_max );
+
+                            if( i == 0 ) {
+                                lm[x][y].fill( light_level );
+                                inside &= light_level <= inside_light_level;
+                                break;
+                            } else {
+                                inside &= light_level <= inside_light_level;
+                                lm[x][y][dir_quadrants[i][0]] = light_level;
+                                lm[x][y][dir_quadrants[i][1]] = light_level;
+                            }
                         }
                     }
                 }
             }
-        }
+            chunk_fully_inside[chunk] = inside;
+        } );
+        fully_inside = std::all_of( chunk_fully_inside.begin(), chunk_fully_inside.end(),
+        []( char inside ) {
+            return inside != 0;
+        } );
     }
 }
 
-void map::generate_lightmap( const int zlev )
+bool recorded_light_source::operator==( const recorded_light_source &rhs ) const
 {
-    level_cache &map_cache = get_cache( zlev );
-    auto &lm = map_cache.lm;
-    auto &sm = map_cache.sm;
-    auto &outside_cache = map_cache.outside_cache;
-    auto &prev_floor_cache = get_cache( clamp( zlev + 1, -OVERMAP_DEPTH, OVERMAP_DEPTH ) ).floor_cache;
-    bool top_floor = zlev == OVERMAP_DEPTH;
-    lm.fill( four_quadrants{} );
-    sm.fill( 0 );
-    map_cache.light_color_cache.fill( light_color_rgb{} );
+    return type == rhs.type && p == rhs.p && luminance == rhs.luminance &&
+           direction == rhs.direction && width == rhs.width && color.r == rhs.color.r &&
+           color.g == rhs.color.g && color.b == rhs.color.b;
+}
 
-    /* Bulk light sources wastefully cast rays into neighbors; a burning hospital can produce
-         significant slowdown, so for stuff like fire and lava:
-     * Step 1: Store the position and luminance in buffer via add_light_source, for efficient
-         checking of neighbors. Color rides the same buffer additively.
-     * Step 2: After everything else, iterate buffer and apply_light_source only in non-redundant
-         directions, propagating both scalar light and color in the same octant decisions.
-     * Step 3: ????
-     * Step 4: Profit!
-     */
-    auto &light_source_buffer = map_cache.light_source_buffer;
-    light_source_buffer.fill( level_cache::buffered_light_source{} );
+bool lightmap_inputs::operator==( const lightmap_inputs &rhs ) const
+{
+    return zlev == rhs.zlev && avatar_z == rhs.avatar_z && max_populated_z == rhs.max_populated_z &&
+           natural_light == rhs.natural_light && sources == rhs.sources &&
+           character_sources == rhs.character_sources && overrides == rhs.overrides;
+}
 
-    constexpr std::array<int, 4> dir_x = { {  0, -1, 1, 0 } };    //    [0]
-    constexpr std::array<int, 4> dir_y = { { -1,  0, 0, 1 } };    // [1][X][2]
-    constexpr std::array<int, 4> dir_d = { { 90, 0, 180, 270 } }; //    [3]
-    constexpr std::array<std::array<quadrant, 2>, 4> dir_quadrants = { {
-            {{ quadrant::NE, quadrant::NW }},
-            {{ quadrant::SW, quadrant::NW }},
-            {{ quadrant::SE, quadrant::NE }},
-            {{ quadrant::SE, quadrant::SW }},
-        }
-    };
+void map::generate_lightmap( const int zlev )
+{
+    // Gather everything the lightmap is built from in one sweep, without casting any light.  If
+    // it all matches what the last lightmap was built from, that one is still correct.
+    // Otherwise the gathered sources are cast from the lists, so the tiles are swept only once
+    // either way.
+    lightmap_inputs inputs;
+    inputs.zlev = zlev;
+    inputs.avatar_z = get_avatar().posz();
+    inputs.max_populated_z = calc_max_populated_zlev();
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+        inputs.natural_light[z + OVERMAP_DEPTH] = g->natural_light_level( z );
+    }
+    std::vector<recorded_light_source> static_sources;
+    gather_light_sources( zlev, inputs, static_sources );
+    const bool static_unchanged = static_light && static_light->zlev == zlev &&
+                                  static_light->sources == static_sources;
+    if( !lightmap_blockers_changed && static_unchanged && last_lightmap_inputs &&
+        *last_lightmap_inputs == inputs ) {
+        return;
+    }
 
-    const float natural_light = g->natural_light_level( zlev );
+    build_lightmap( zlev, inputs, std::move( static_sources ) );
+    last_lightmap_inputs = std::move( inputs );
+    lightmap_blockers_changed = false;
+}
 
-    build_sunlight_cache( zlev );
+void map::gather_light_sources( const int zlev, lightmap_inputs &inputs,
+                                std::vector<recorded_light_source> &static_sources )
+{
+    recorded_light_sources = &inputs.sources;
 
     apply_character_light( get_player_character() );
     for( npc &guy : g->all_npcs() ) {
         apply_character_light( guy );
     }
+    // The light let in through openings into buildings is cast after these, see build_lightmap()
+    inputs.character_sources = inputs.sources.size();
 
-    std::vector<std::pair<tripoint_bub_ms, float>> lm_override;
     // Traverse the submaps in order
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
@@ -502,40 +544,10 @@ void map::generate_lightmap( const int zlev )
                 for( int sy = 0; sy < SEEY; ++sy ) {
                     const point_bub_ms p2( sx + smx * SEEX, sy + smy * SEEY );
                     const tripoint_bub_ms p( p2, zlev );
-                    // Project light into any openings into buildings.
-                    if( !outside_cache[p.x()][p.y()] || ( !top_floor && prev_floor_cache[p.x()][p.y()] ) ) {
-                        // Apply light sources for external/internal divide
-                        for( int i = 0; i < 4; ++i ) {
-                            point_bub_ms neighbour = p.xy() + point( dir_x[i], dir_y[i] );
-                            if( lightmap_boundaries.contains( neighbour )
-                                && outside_cache[neighbour.x()][neighbour.y()] &&
-                                ( top_floor || !prev_floor_cache[neighbour.x()][neighbour.y()] )
-                              ) {
-                                const float source_light =
-                                    std::min( natural_light, lm[neighbour.x()][neighbour.y()].max() );
-                                if( light_transparency( p ) > LIGHT_TRANSPARENCY_SOLID ) {
-                                    update_light_quadrants( lm[p.x()][p.y()], source_light, quadrant::default_ );
-                                    apply_directional_light( p, dir_d[i], source_light );
-                                } else {
-                                    update_light_quadrants( lm[p.x()][p.y()], source_light, dir_quadrants[i][0] );
-                                    update_light_quadrants( lm[p.x()][p.y()], source_light, dir_quadrants[i][1] );
-                                }
-                            }
-                        }
-                    }
-
-                    if( cur_submap->get_lum( { sx, sy } ) ) {
-                        add_light_from_items( p, i_at( p ) );
-                    }
 
-                    const ter_id &terrain = cur_submap->get_ter( { sx, sy } );
-                    if( terrain->light_emitted > 0 ) {
-                        add_light_source( p, terrain->light_emitted, terrain->light_color );
-                    }
-                    const furn_id &furniture = cur_submap->get_furn( {sx, sy } );
-                    if( furniture->light_emitted > 0 ) {
-                        add_light_source( p, furniture->light_emitted, furniture->light_color );
-                    }
+                    recorded_light_sources = &static_sources;
+                    add_static_light_sources( *cur_submap, { sx, sy }, p );
+                    recorded_light_sources = &inputs.sources;
 
                     for( const auto &fld : cur_submap->get_field( { sx, sy } ) ) {
                         const field_entry *cur = &fld.second;
@@ -544,7 +556,7 @@ void map::generate_lightmap( const int zlev )
                             add_light_source( p, fil.light_emitted, fil.light_color );
                         }
                         if( fil.local_light_override >= 0.0f ) {
-                            lm_override.emplace_back( p, fil.local_light_override );
+                            inputs.overrides.emplace_back( p, fil.local_light_override );
                         }
                     }
                 }
@@ -652,20 +664,136 @@ void map::generate_lightmap( const int zlev )
         }
     }
 
+    recorded_light_sources = nullptr;
+}
+
+void map::apply_recorded_light_source( const recorded_light_source &src )
+{
+    switch( src.type ) {
+        case recorded_light_source::kind::point:
+            apply_light_source( src.p, src.luminance );
+            break;
+        case recorded_light_source::kind::buffered:
+            add_light_source( src.p, src.luminance, src.color );
+            break;
+        case recorded_light_source::kind::arc:
+            apply_light_arc( src.p, src.direction, src.luminance, src.width, src.color );
+            break;
+    }
+}
+
+void map::build_lightmap( const int zlev, const lightmap_inputs &inputs,
+                          std::vector<recorded_light_source> &&static_sources )
+{
+    level_cache &map_cache = get_cache( zlev );
+    auto &lm = map_cache.lm;
+    auto &sm = map_cache.sm;
+    auto &outside_cache = map_cache.outside_cache;
+    auto &prev_floor_cache = get_cache( clamp( zlev + 1, -OVERMAP_DEPTH, OVERMAP_DEPTH ) ).floor_cache;
+    bool top_floor = zlev == OVERMAP_DEPTH;
+    lm.fill( four_quadrants{} );
+    sm.fill( 0 );
+    map_cache.light_color_cache.fill( light_color_rgb{} );
+
+    /* Bulk light sources wastefully cast rays into neighbors; a burning hospital can produce
+         significant slowdown, so for stuff like fire and lava:
+     * Step 1: Store the position and luminance in buffer via add_light_source, for efficient
+         checking of neighbors. Color rides the same buffer additively.
+     * Step 2: After everything else, iterate buffer and apply_light_source only in non-redundant
+         directions, propagating both scalar light and color in the same octant decisions.
+     * Step 3: ????
+     * Step 4: Profit!
+     */
+    auto &light_source_buffer = map_cache.light_source_buffer;
+    light_source_buffer.fill( level_cache::buffered_light_source{} );
+
+    constexpr std::array<int, 4> dir_x = { {  0, -1, 1, 0 } };    //    [0]
+    constexpr std::array<int, 4> dir_y = { { -1,  0, 0, 1 } };    // [1][X][2]
+    constexpr std::array<int, 4> dir_d = { { 90, 0, 180, 270 } }; //    [3]
+    constexpr std::array<std::array<quadrant, 2>, 4> dir_quadrants = { {
+            {{ quadrant::NE, quadrant::NW }},
+            {{ quadrant::SW, quadrant::NW }},
+            {{ quadrant::SE, quadrant::NE }},
+            {{ quadrant::SE, quadrant::SW }},
+        }
+    };
+
+    const float natural_light = g->natural_light_level( zlev );
+
+    bake_static_light( zlev, std::move( static_sources ) );
+    build_sunlight_cache( zlev );
+
+    for( size_t i = 0; i < inputs.character_sources; ++i ) {
+        apply_recorded_light_source( inputs.sources[i] );
+    }
+
+    // Traverse the submaps in the same order as when gathering, openings light each other
+    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+        for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( get_submap_at_grid( tripoint_rel_sm{ smx, smy, zlev } ) == nullptr ) {
+                continue;
+            }
+            for( int sx = 0; sx < SEEX; ++sx ) {
+                for( int sy = 0; sy < SEEY; ++sy ) {
+                    const tripoint_bub_ms p( sx + smx * SEEX, sy + smy * SEEY, zlev );
+                    // Project light into any openings into buildings.
+                    if( outside_cache[p.x()][p.y()] &&
+                        ( top_floor || !prev_floor_cache[p.x()][p.y()] ) ) {
+                        continue;
+                    }
+                    // Apply light sources for external/internal divide
+                    for( int i = 0; i < 4; ++i ) {
+                        point_bub_ms neighbour = p.xy() + point( dir_x[i], dir_y[i] );
+                        if( lightmap_boundaries.contains( neighbour )
+                            && outside_cache[neighbour.x()][neighbour.y()] &&
+                            ( top_floor || !prev_floor_cache[neighbour.x()][neighbour.y()] )
+                          ) {
+                            const float source_light =
+                                std::min( natural_light, lm[neighbour.x()][neighbour.y()].max() );
+                            if( light_transparency( p ) > LIGHT_TRANSPARENCY_SOLID ) {
+                                update_light_quadrants( lm[p.x()][p.y()], source_light,
+                                                        quadrant::default_ );
+                                apply_directional_light( p, dir_d[i], source_light );
+                            } else {
+                                update_light_quadrants( lm[p.x()][p.y()], source_light,
+                                                        dir_quadrants[i][0] );
+                                update_light_quadrants( lm[p.x()][p.y()], source_light,
+                                                        dir_quadrants[i][1] );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for( size_t i = inputs.character_sources; i < inputs.sources.size(); ++i ) {
+        apply_recorded_light_source( inputs.sources[i] );
+    }
+
     /* Now that we have position and intensity of all bulk light sources, apply_ them
       This may seem like extra work, but take a 12x12 raging inferno:
         unbuffered: (12^2)*(160*4) = apply_light_ray x 92160
         buffered:   (12*4)*(160)   = apply_light_ray x 7680
     */
-    const tripoint_bub_ms cache_start( 0, 0, zlev );
-    const tripoint_bub_ms cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
-    for( const tripoint_bub_ms &p : points_in_rectangle( cache_start, cache_end ) ) {
-        if( light_source_buffer[p.x()][p.y()].luminance > 0.0 ) {
-            apply_light_source( p, light_source_buffer[p.x()][p.y()].luminance );
+    apply_buffered_light_sources( zlev );
+
+    // Light combines by taking the brightest, so adding the static light last gives the same
+    // result as casting it along with everything else.
+    auto &light_color_cache = map_cache.light_color_cache;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            lm[x][y] = elementwise_max( lm[x][y], static_light->lm[x][y] );
+            sm[x][y] = std::max( sm[x][y], static_light->sm[x][y] );
+            const light_color_rgb &baked_color = static_light->light_color[x][y];
+            light_color_rgb &color = light_color_cache[x][y];
+            color.r = std::max( color.r, baked_color.r );
+            color.g = std::max( color.g, baked_color.g );
+            color.b = std::max( color.b, baked_color.b );
         }
     }
 
-    for( const std::pair<tripoint_bub_ms, float> &elem : lm_override ) {
+    for( const std::pair<tripoint_bub_ms, float> &elem : inputs.overrides ) {
         lm[elem.first.x()][elem.first.y()].fill( elem.second );
     }
 
@@ -673,7 +801,6 @@ void map::generate_lightmap( const int zlev )
     // Even with per-channel max in update_light_color, attenuation differences
     // between adjacent octants can leave visible intensity steps.
     {
-        auto &light_color_cache = map_cache.light_color_cache;
         static auto blur_buf =
             std::make_unique<cata::mdarray<light_color_rgb, point_bub_ms>>();
         blur_buf->fill( light_color_rgb{} );
@@ -703,9 +830,99 @@ void map::generate_lightmap( const int zlev )
     }
 }
 
+void map::add_static_light_sources( const submap &sm, const point_sm_ms &sp,
+                                    const tripoint_bub_ms &p )
+{
+    if( sm.get_lum( sp ) ) {
+        add_light_from_items( p, i_at( p ) );
+    }
+
+    const ter_id &terrain = sm.get_ter( sp );
+    if( terrain->light_emitted > 0 ) {
+        add_light_source( p, terrain->light_emitted, terrain->light_color );
+    }
+    const furn_id &furniture = sm.get_furn( sp );
+    if( furniture->light_emitted > 0 ) {
+        add_light_source( p, furniture->light_emitted, furniture->light_color );
+    }
+}
+
+// Whether transparency changed anywhere the baked sources could have lit.
+static bool baked_light_blockers_changed( const baked_static_light &baked )
+{
+    if( baked.blockers_changed.none() ) {
+        return false;
+    }
+    for( const recorded_light_source &src : baked.sources ) {
+        // Light falls off at least as fast as luminance / distance, and goes dark below
+        // LIGHT_AMBIENT_LOW.  Doubled to stay clear of fastexp()'s error.
+        const int reach = std::min( static_cast<int>( 2.0f * src.luminance / LIGHT_AMBIENT_LOW ) + 1,
+                                    MAX_VIEW_DISTANCE );
+        const int min_smx = std::max( src.p.x() - reach, 0 ) / SEEX;
+        const int max_smx = std::min( src.p.x() + reach, MAPSIZE_X - 1 ) / SEEX;
+        const int min_smy = std::max( src.p.y() - reach, 0 ) / SEEY;
+        const int max_smy = std::min( src.p.y() + reach, MAPSIZE_Y - 1 ) / SEEY;
+        for( int smx = min_smx; smx <= max_smx; ++smx ) {
+            for( int smy = min_smy; smy <= max_smy; ++smy ) {
+                if( baked.blockers_changed[smx * MAPSIZE + smy] ) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void map::bake_static_light( const int zlev, std::vector<recorded_light_source> &&sources )
+{
+    if( static_light && static_light->zlev == zlev && static_light->sources == sources &&
+        !baked_light_blockers_changed( *static_light ) ) {
+        return;
+    }
+    if( !static_light ) {
+        static_light = std::make_unique<baked_static_light>();
+    }
+
+    // Cast the static sources on their own into the cleared caches, and move the result over.
+    for( const recorded_light_source &src : sources ) {
+        apply_recorded_light_source( src );
+    }
+    apply_buffered_light_sources( zlev );
+
+    level_cache &map_cache = get_cache( zlev );
+    static_light->lm = map_cache.lm;
+    static_light->sm = map_cache.sm;
+    static_light->light_color = map_cache.light_color_cache;
+    map_cache.lm.fill( four_quadrants{} );
+    map_cache.sm.fill( 0 );
+    map_cache.light_color_cache.fill( light_color_rgb{} );
+    map_cache.light_source_buffer.fill( level_cache::buffered_light_source{} );
+
+    static_light->zlev = zlev;
+    static_light->sources = std::move( sources );
+    static_light->blockers_changed.reset();
+}
+
+void map::apply_buffered_light_sources( const int zlev )
+{
+    const auto &light_source_buffer = get_cache( zlev ).light_source_buffer;
+    const tripoint_bub_ms cache_start( 0, 0, zlev );
+    const tripoint_bub_ms cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
+    for( const tripoint_bub_ms &p : points_in_rectangle( cache_start, cache_end ) ) {
+        if( light_source_buffer[p.x()][p.y()].luminance > 0.0 ) {
+            apply_light_source( p, light_source_buffer[p.x()][p.y()].luminance );
+        }
+    }
+}
+
 void map::add_light_source( const tripoint_bub_ms &p, float luminance,
                             const light_color_rgb &color )
 {
+    if( recorded_light_sources != nullptr ) {
+        recorded_light_sources->push_back( { recorded_light_source::kind::buffered, p, luminance,
+                                             0_degrees, 0_degrees, color } );
+        return;
+    }
     auto &buf = get_cache( p.z() ).light_source_buffer[p.x()][p.y()];
     if( luminance > buf.luminance ) {
         buf.luminance = luminance;
@@ -1001,11 +1218,13 @@ void castLight( cata::mdarray<Out, point_bub_ms> &output_cache,
         return;
     }
     T last_intensity( 0.0 );
+    memoized_calc<T, calc> intensity( numerator );
     tripoint delta;
     for( int distance = row; distance <= radius; distance++ ) {
         delta.y = -distance;
         bool started_row = false;
         T current_transparency( 0.0 );
+        intensity.reset();
         float away = start - ( -distance + 0.5f ) / ( -distance -
                      0.5f ); //The distance between our first leadingEdge and start
 
@@ -1029,7 +1248,7 @@ void castLight( cata::mdarray<Out, point_bub_ms> &output_cache,
             }
 
             const int dist = rl_dist( tripoint::zero, delta ) + offsetDistance;
-            last_intensity = calc( numerator, cumulative_transparency, dist );
+            last_intensity = intensity( cumulative_transparency, dist );
 
             T new_transparency = input_array[ current.x ][ current.y ];
 
@@ -1042,6 +1261,34 @@ void castLight( cata::mdarray<Out, point_bub_ms> &output_cache,
 
             if( new_transparency == current_transparency ) {
                 newStart = leadingEdge;
+                if constexpr( xx == 0 ) {
+                    if( !shadowcasting_batch_runs ) {
+                        continue;
+                    }
+                    // The rest of this row is contiguous in the caches, so find how many of the
+                    // following tiles continue the run and light them without the per tile
+                    // bookkeeping above.
+                    const int run_limit = std::min( -delta.x,
+                                                    yx > 0 ? MAPSIZE_Y - 1 - current.y : current.y );
+                    int run = equal_run_length( &input_array[current.x][current.y] + yx, yx, run_limit,
+                                                current_transparency );
+                    // Stop short of the tile where the loop above would break.
+                    while( run > 0 && end > ( delta.x + run - 0.5f ) / ( delta.y + 0.5f ) ) {
+                        --run;
+                    }
+                    for( int i = 0; i < run; i++ ) {
+                        delta.x++;
+                        current.y += yx;
+                        last_intensity = intensity( cumulative_transparency,
+                                                    rl_dist( tripoint::zero, delta ) + offsetDistance );
+                        update_output( output_cache[current.x][current.y], last_intensity,
+                                       check( current_transparency, last_intensity ) ?
+                                       quadrant::default_ : quad );
+                    }
+                    if( run > 0 ) {
+                        newStart = ( delta.x + 0.5f ) / ( delta.y - 0.5f );
+                    }
+                }
                 continue;
             }
             // Only cast recursively if previous span was not opaque.
@@ -1170,9 +1417,31 @@ void map::build_seen_cache( const tripoint_bub_ms &origin, const int target_z, i
         ( *seen_caches[ target_z + OVERMAP_DEPTH ] )[origin.x()][origin.y()] = VISIBILITY_FULL;
     }
 
-    cast_zlight<float, sight_calc, sight_check, accumulate_transparency>(
-        seen_caches, transparency_caches, floor_caches, origin, penalty, 1.0,
-        directions_to_cast );
+    thread_pool &pool = get_thread_pool();
+    if( directions_to_cast == vertical_direction::BOTH && pool.worker_count() > 0 ) {
+        // The casts up and down only meet on the origin's level, so they can run side by side
+        // if the upward one writes that level into a copy, merged back once both are done.
+        const int origin_index = origin.z() + OVERMAP_DEPTH;
+        mdarray &origin_level = *seen_caches[origin_index];
+        std::unique_ptr<mdarray> origin_level_up = std::make_unique<mdarray>( origin_level );
+        array_of_grids_of<float> up_caches = seen_caches;
+        up_caches[origin_index] = origin_level_up.get();
+        pool.parallel_for( 2, [&]( size_t i ) {
+            cast_zlight<float, sight_calc, sight_check, accumulate_transparency>(
+                i == 0 ? seen_caches : up_caches, transparency_caches, floor_caches, origin, penalty,
+                1.0, i == 0 ? vertical_direction::DOWN : vertical_direction::UP );
+        } );
+        std::transform( &origin_level[0][0], &origin_level[0][0] + map_dimensions,
+                        &( *origin_level_up )[0][0], &origin_level[0][0],
+        []( float down, float up ) {
+            return std::max( down, up );
+        } );
+    } else {
+        cast_zlight<float, sight_calc, sight_check, accumulate_transparency>(
+            seen_caches, transparency_caches, floor_caches, origin, penalty, 1.0,
+            directions_to_cast );
+    }
+    // Ledges hide tiles across levels, so they have to wait for every level to be cast.
     seen_cache_process_ledges( seen_caches, floor_caches, std::nullopt );
 
     const optional_vpart_position vp = veh_at( origin );
@@ -1310,6 +1579,11 @@ static bool light_check( const float &transparency, const float &intensity )
 
 void map::apply_light_source( const tripoint_bub_ms &p, float luminance )
 {
+    if( recorded_light_sources != nullptr ) {
+        recorded_light_sources->push_back( { recorded_light_source::kind::point, p, luminance,
+                                             0_degrees, 0_degrees, {} } );
+        return;
+    }
     level_cache &cache = get_cache( p.z() );
     auto &lm = cache.lm;
     auto &sm = cache.sm;
@@ -1485,6 +1759,11 @@ void map::apply_directional_light( const tripoint_bub_ms &p, int direction, floa
 void map::apply_light_arc( const tripoint_bub_ms &p, const units::angle &angle, float luminance,
                            const units::angle &wideangle, const light_color_rgb &color )
 {
+    if( recorded_light_sources != nullptr ) {
+        recorded_light_sources->push_back( { recorded_light_source::kind::arc, p, luminance, angle,
+                                             wideangle, color } );
+        return;
+    }
     if( luminance <= LIGHT_SOURCE_LOCAL ) {
         return;
     }
@@ -2014,7 +2014,7 @@ bool map::furn_set( const tripoint_bub_ms &p, const furn_id &new_furniture, cons
         }
     }
     if( !new_f.emissions.empty() ) {
-        field_furn_locs.push_back( p );
+        field_furn_locs[emitter_slot( p )].push_back( p );
     }
     if( old_f.transparent != new_f.transparent ||
         old_f.has_flag( ter_furn_flag::TFLAG_TRANSLUCENT ) != new_f.has_flag(
@@ -2502,7 +2502,7 @@ bool map::ter_set( const tripoint_bub_ms &p, const ter_id &new_terrain, bool avo
         traplocs[new_t.trap.to_i()].push_back( p );
     }
     if( !new_t.emissions.empty() ) {
-        field_ter_locs.push_back( p );
+        field_ter_locs[emitter_slot( p )].push_back( p );
     }
     if( old_t.transparent != new_t.transparent ||
         old_t.has_flag( ter_furn_flag::TFLAG_TRANSLUCENT ) != new_t.has_flag(
@@ -7226,6 +7226,7 @@ bool map::add_field( const tripoint_bub_ms &p, const field_type_id &type_id, int
     current_submap->ensure_nonuniform();
     invalidate_max_populated_zlev( p.z() );
 
+    current_submap->mark_field_square( l );
     if( current_submap->get_field( l ).add_field( converted_type_id, intensity, age, source ) ) {
         //Only adding it to the count if it doesn't exist.
         if( !current_submap->field_count++ ) {
@@ -7992,8 +7993,7 @@ bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int ra
     return sees( F, T, range, dummy, with_fields );
 }
 
-// TODO: Change this to a hash function on the map implementation. This will also allow us to
-// account for the complete lack of entropy in the top 16 bits.
+// skew_vision_cache hashes these, so the packing only has to be unique.
 point map::sees_cache_key( const tripoint_bub_ms &from, const tripoint_bub_ms &to ) const
 {
     // Canonicalize the order of the tripoints so the cache is reflexive.
@@ -8015,7 +8015,7 @@ bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int ra
 {
     bool ( map:: * f_transparent )( const tripoint_bub_ms & p ) const =
         with_fields ? &map::is_transparent : &map::is_transparent_wo_fields;
-    lru_cache_t &skew_cache = with_fields ? skew_vision_cache : skew_vision_wo_fields_cache;
+    skew_vision_cache &skew_cache = with_fields ? skew_vision : skew_vision_wo_fields;
     if( std::abs( F.z() - T.z() ) > fov_3d_z_range ||
         ( range >= 0 && range < rl_dist( F, T ) ) ||
         !inbounds( T ) ) {
@@ -8045,7 +8045,7 @@ bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int ra
             }
             return true;
         } );
-        skew_cache.insert( 100000, key, visible ? 1 : 0 );
+        skew_cache.insert( key, visible ? 1 : 0 );
         return visible;
     }
 
@@ -8078,7 +8078,7 @@ bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int ra
         last_point = new_point;
         return true;
     } );
-    skew_cache.insert( 100000, key, visible ? 1 : 0 );
+    skew_cache.insert( key, visible ? 1 : 0 );
     return visible;
 }
 
@@ -8530,8 +8530,12 @@ void map::load( const tripoint_abs_sm &w, const bool update_vehicle,
     for( auto &traps : traplocs ) {
         traps.clear();
     }
-    field_furn_locs.clear();
-    field_ter_locs.clear();
+    for( std::vector<tripoint_bub_ms> &locs : field_furn_locs ) {
+        locs.clear();
+    }
+    for( std::vector<tripoint_bub_ms> &locs : field_ter_locs ) {
+        locs.clear();
+    }
     submaps_with_active_items.clear();
     submaps_with_active_items_dirty.clear();
     set_abs_sub( w );
@@ -8568,24 +8572,21 @@ void map::shift_traps( const point_rel_sm &shift )
 {
     // Offset needs to have sign opposite to shift direction
     const tripoint_rel_ms offset( -shift.x() * SEEX, -shift.y() * SEEY, 0 );
-    for( auto iter = field_furn_locs.begin(); iter != field_furn_locs.end(); ) {
-        tripoint_bub_ms &pos = *iter;
-        pos += offset;
-        if( inbounds( pos ) ) {
-            ++iter;
-        } else {
-            iter = field_furn_locs.erase( iter );
-        }
-    }
-    for( auto iter = field_ter_locs.begin(); iter != field_ter_locs.end(); ) {
-        tripoint_bub_ms &pos = *iter;
-        pos += offset;
-        if( inbounds( pos ) ) {
-            ++iter;
-        } else {
-            iter = field_ter_locs.erase( iter );
+    const auto shift_emitters = [&]( emitter_wheel & wheel ) {
+        for( std::vector<tripoint_bub_ms> &locs : wheel ) {
+            for( auto iter = locs.begin(); iter != locs.end(); ) {
+                tripoint_bub_ms &pos = *iter;
+                pos += offset;
+                if( inbounds( pos ) ) {
+                    ++iter;
+                } else {
+                    iter = locs.erase( iter );
+                }
+            }
         }
-    }
+    };
+    shift_emitters( field_furn_locs );
+    shift_emitters( field_ter_locs );
     for( auto &traps : traplocs ) {
         for( auto iter = traps.begin(); iter != traps.end(); ) {
             tripoint_bub_ms &pos = *iter;
@@ -9421,10 +9422,10 @@ void map::actualize( const tripoint_rel_sm &grid )
             const furn_t &furn = *this->furn( pnt );
             const ter_t &terr = *this->ter( pnt );
             if( !furn.emissions.empty() ) {
-                field_furn_locs.push_back( pnt );
+                field_furn_locs[emitter_slot( pnt )].push_back( pnt );
             }
             if( !terr.emissions.empty() ) {
-                field_ter_locs.push_back( pnt );
+                field_ter_locs[emitter_slot( pnt )].push_back( pnt );
             }
 
             const trap_id trap_here = tmpsub->get_trap( p );
@@ -9846,14 +9847,12 @@ void map::clear_traps()
     }
 }
 
-const std::vector<tripoint_bub_ms> &map::get_furn_field_locations() const
-{
-    return field_furn_locs;
-}
-
-const std::vector<tripoint_bub_ms> &map::get_ter_field_locations() const
+int map::emitter_slot( const tripoint_bub_ms &p ) const
 {
-    return field_ter_locs;
+    const tripoint_abs_ms abs = get_abs( p );
+    // Neighbouring emitters, like the tiles of a large machine, emit on different turns.
+    const int slot = ( abs.x() + 3 * abs.y() + 7 * abs.z() ) % emitter_period;
+    return slot < 0 ? slot + emitter_period : slot;
 }
 
 const std::vector<tripoint_bub_ms> &map::trap_locations( const trap_id &type ) const
@@ -10090,6 +10089,7 @@ void map::build_outside_cache( const int zlev )
         return;
     }
     level_cache &ch = *ch_lazy;
+    lightmap_blockers_changed = true;
 
     // Make a bigger cache to avoid bounds checking
     // We will later copy it to our regular cache
@@ -10101,6 +10101,7 @@ void map::build_outside_cache( const int zlev )
     if( zlev < 0 ) {
         std::uninitialized_fill_n(
             &outside_cache[0][0], MAPSIZE_X * MAPSIZE_Y, false );
+        ch.outside_cache_dirty = false;
         return;
     }
 
@@ -10247,6 +10248,7 @@ bool map::build_floor_cache( const int zlev )
         return false;
     }
     level_cache &ch = *ch_lazy;
+    lightmap_blockers_changed = true;
 
     auto &floor_cache = ch.floor_cache;
     std::uninitialized_fill_n(
@@ -10395,8 +10397,8 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
     }
 
     if( seen_cache_dirty ) {
-        skew_vision_cache.clear();
-        skew_vision_wo_fields_cache.clear();
+        skew_vision.clear();
+        skew_vision_wo_fields.clear();
     }
     avatar &u = get_avatar();
     Character::moncam_cache_t mcache = u.get_active_moncams();
@@ -11370,12 +11372,15 @@ void map::update_pathfinding_cache( int zlev ) const
             }
         }
         cache.dirty = false;
+        cache.areas_dirty.fill( true );
     } else {
         for( const point_bub_ms &p : cache.dirty_points ) {
             update_pathfinding_cache( { p, zlev } );
+            cache.areas_dirty[project_to<coords::sm>( p )] = true;
         }
     }
     cache.dirty_points.clear();
+    ++cache.revision;
 }
 
 void map::clip_to_bounds( tripoint_bub_ms &p ) const
@@ -11486,7 +11491,7 @@ void map::invalidate_max_populated_zlev( int zlev )
 bool map::has_potential_los( const tripoint_bub_ms &from, const tripoint_bub_ms &to ) const
 {
     const point key = sees_cache_key( from, to );
-    char cached = skew_vision_cache.get( key, -1 );
+    char cached = skew_vision.get( key, -1 );
     if( cached != -1 ) {
         return cached > 0;
     }
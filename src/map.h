@@ -35,13 +35,13 @@
 #include "level_cache.h"
 #include "lightmap.h"
 #include "line.h"
-#include "lru_cache.h"
 #include "map_iterator.h"
 #include "map_selector.h"
 #include "mapdata.h"
 #include "maptile_fwd.h"
 #include "point.h"
 #include "rng.h"
+#include "skew_vision_cache.h"
 #include "type_id.h"
 #include "units.h"
 #include "value_ptr.h"
@@ -98,6 +98,8 @@ class map;
 class weather_generator;
 
 enum class ter_furn_flag : int;
+struct flow_field;
+struct flow_field_cache;
 struct pathfinding_cache;
 struct pathfinding_settings;
 struct pathfinding_target;
@@ -571,6 +573,23 @@ class map
         void create_hot_air( const tripoint_bub_ms &p, int intensity );
         bool gas_can_spread_to( field_entry &cur, const maptile &dst );
         void gas_spread_to( field_entry &cur, maptile &dst, const tripoint_bub_ms &p );
+        /** Gas thick enough to spread, as found by spread_gas(). */
+        struct gas_source {
+            tripoint_bub_ms p;
+            field_type_id type;
+            int percent_spread = 0;
+            // Found on the calling thread, as checking for vehicles may refresh their caches
+            bool sheltered = false;
+            int windpower = 0;
+        };
+        /**
+         * Picks where the gas of source spreads to, if anywhere, drawing only from engine.
+         * Doesn't change the map, so it can run for several sources at once.
+         */
+        std::optional<tripoint_bub_ms> pick_gas_move( const gas_source &source,
+                cata_default_random_engine &engine );
+        // Picks the moves of all sources on the thread pool, a submap per task, then applies them.
+        void spread_gas_sources( const std::vector<gas_source> &sources );
         int burn_body_part( Character &you, field_entry &cur, const bodypart_id &bp, int scale );
     public:
 
@@ -731,6 +750,10 @@ class map
         /**
          * Calculate the best path using A*
          *
+         * Many creatures pathing to the same point on the same z-level share a flow field
+         * instead, built once enough of them asked for it on one turn. Their route is an
+         * equally short one, but not always the same as the one A* would have found.
+         *
          * @param f The source location from which to path.
          * @param target The destination to which to path.
          * @param settings Structure describing pathfinding parameters.
@@ -770,6 +793,25 @@ class map
         int extra_cost( const tripoint_bub_ms &cur, const tripoint_bub_ms &p,
                         const pathfinding_settings &settings,
                         PathfindingFlags p_special ) const;
+        // The flow field for routes to t with settings, if enough routes to it were asked for
+        // this turn that building one pays off. Null otherwise.
+        const flow_field *shared_flow_field( const tripoint_bub_ms &t,
+                                             const pathfinding_settings &settings ) const;
+        void build_flow_field( flow_field &field ) const;
+        // The A* search of route(), within the box from min to max and, if given, within the
+        // submaps marked in corridor.
+        std::vector<tripoint_bub_ms> route_search( const tripoint_bub_ms &f,
+                const pathfinding_target &target, const pathfinding_settings &settings,
+                const std::function<bool( const tripoint_bub_ms & )> &avoid,
+                const tripoint_bub_ms &min, const tripoint_bub_ms &max,
+                const cata::mdarray<bool, point_bub_sm> *corridor ) const;
+        // The submaps, and the ones around them, that a route from f to t within the box from
+        // min to max passes through when going over open ground. Nothing if there is no such route,
+        // or if it is a long detour that settings may allow cutting short through a door or wall.
+        std::optional<cata::mdarray<bool, point_bub_sm>> route_corridor( const tripoint_bub_ms &f,
+                const tripoint_bub_ms &t, const tripoint_bub_ms &min, const tripoint_bub_ms &max,
+                const pathfinding_settings &settings ) const;
+        void update_path_areas( int zlev ) const;
         // Catches up renewable generation (solar/wind/water) for off-map vehicles
         // that are connected to in-bubble grids via cables.
         void resolve_off_map_grid_generation();
@@ -1470,8 +1512,6 @@ class map
         bool can_see_trap_at( const tripoint_bub_ms &p, const Character &c ) const;
 
         void remove_trap( const tripoint_bub_ms &p );
-        const std::vector<tripoint_bub_ms> &get_furn_field_locations() const;
-        const std::vector<tripoint_bub_ms> &get_ter_field_locations() const;
         const std::vector<tripoint_bub_ms> &trap_locations( const trap_id &type ) const;
 
         /**
@@ -1642,6 +1682,12 @@ class map
          * @param mul Multiplies the chance and possibly qty (if `chance*mul > 100`) of the emission
          */
         void emit_field( const tripoint_bub_ms &pos, const emit_id &src, float mul = 1.0f );
+        /**
+         * Runs the emissions of the field-emitting furniture and terrain due this turn.  Each of
+         * them emits once every @ref emitter_period, on a turn picked by its location.
+         */
+        void emit_fields_due();
+        static constexpr int emitter_period = 10;
 
         // Scent propagation helpers
         /**
@@ -1968,6 +2014,10 @@ class map
                                         const std::optional<tripoint_bub_ms> &override_p ) const;
 
     protected:
+        /**
+         * Builds the lightmap of zlev, or keeps the last one if it was built for the same
+         * lightmap_inputs and nothing that blocks light has changed since.
+         */
         void generate_lightmap( int zlev );
         void build_seen_cache( const tripoint_bub_ms &origin, int target_z,
                                int extension_range = MAX_VIEW_DISTANCE,
@@ -2113,6 +2163,25 @@ class map
                               const tripoint_bub_ms &s, const tripoint_bub_ms &e, float luminance );
         void add_light_from_items( const tripoint_bub_ms &p, const item_stack &items );
         void add_item_light_recursive( const tripoint_bub_ms &p, const item &it );
+        // Gathers the light sources of the lightmap of zlev without casting them, the ones
+        // add_static_light_sources() finds into static_sources and the rest into inputs.
+        void gather_light_sources( int zlev, lightmap_inputs &inputs,
+                                   std::vector<recorded_light_source> &static_sources );
+        void apply_recorded_light_source( const recorded_light_source &src );
+        // Casts the lightmap of zlev from what gather_light_sources() found.
+        void build_lightmap( int zlev, const lightmap_inputs &inputs,
+                             std::vector<recorded_light_source> &&static_sources );
+        // Light sources of terrain, furniture and items on the ground at p.
+        void add_static_light_sources( const submap &sm, const point_sm_ms &sp,
+                                       const tripoint_bub_ms &p );
+        /**
+         * Makes static_light hold the light of the static sources on zlev, casting it again
+         * only if those sources or the transparency of the submaps they reach have changed.
+         * Expects the light caches of zlev to be clear and leaves them that way.
+         */
+        void bake_static_light( int zlev, std::vector<recorded_light_source> &&sources );
+        // Casts the sources gathered by add_light_source() on zlev.
+        void apply_buffered_light_sources( int zlev );
         std::unique_ptr<vehicle> add_vehicle_to_map( std::unique_ptr<vehicle> veh, bool merge_wrecks );
 
         // Internal methods used to bash just the selected features
@@ -2176,20 +2245,26 @@ class map
          * tr_null trap.
          */
         std::vector< std::vector<tripoint_bub_ms> > traplocs;
+        // Locations of field emitters, in the slot of the turn they emit on, see emitter_slot().
+        using emitter_wheel = std::array<std::vector<tripoint_bub_ms>, emitter_period>;
         /**
-         * Vector of tripoints containing active field-emitting furniture
+         * Tripoints containing active field-emitting furniture
          */
-        std::vector<tripoint_bub_ms> field_furn_locs;
+        emitter_wheel field_furn_locs;
         /**
-         * Vector of tripoints containing active field-emitting terrain
+         * Tripoints containing active field-emitting terrain
          */
-        std::vector<tripoint_bub_ms> field_ter_locs;
+        emitter_wheel field_ter_locs;
+        // Slot of field_furn_locs and field_ter_locs for an emitter at p.  It only depends on
+        // the absolute location, so it does not change when the map shifts.
+        int emitter_slot( const tripoint_bub_ms &p ) const;
         /**
          * Holds caches for visibility, light, transparency and vehicles
          */
         mutable std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        mutable std::unique_ptr<flow_field_cache> flow_fields;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
@@ -2199,9 +2274,19 @@ class map
         /**
          * Cache of coordinate pairs recently checked for visibility.
          */
-        using lru_cache_t = lru_cache<point, char>;
-        mutable lru_cache_t skew_vision_cache;
-        mutable lru_cache_t skew_vision_wo_fields_cache;
+        mutable skew_vision_cache skew_vision;
+        mutable skew_vision_cache skew_vision_wo_fields;
+
+        // While set, the light source functions append here instead of casting light.
+        std::vector<recorded_light_source> *recorded_light_sources = nullptr;
+        // Inputs of the last lightmap built, see generate_lightmap()
+        std::optional<lightmap_inputs> last_lightmap_inputs;
+        // Set whenever a cache of what blocks light is rebuilt
+        bool lightmap_blockers_changed = true;
+        std::unique_ptr<baked_static_light> static_light;
+        // While set, spread_gas() appends here and the gas is only spread at the end of
+        // process_fields(), from the fields as they were left by the pass.
+        std::vector<gas_source> *pending_gas_sources = nullptr;
 
         // Note: no bounds check
         level_cache &get_cache( int zlev ) const {
@@ -9,6 +9,7 @@
 #include <memory>
 #include <optional>
 #include <queue>
+#include <random>
 #include <set>
 #include <string>
 #include <tuple>
@@ -34,6 +35,7 @@
 #include "fire.h"
 #include "fungal_effects.h"
 #include "game.h"
+#include "hash_utils.h"
 #include "item.h"
 #include "itype.h"
 #include "level_cache.h"
@@ -50,6 +52,7 @@
 #include "mtype.h"
 #include "npc.h"
 #include "overmapbuffer.h"
+#include "perf.h"
 #include "point.h"
 #include "rng.h"
 #include "scent_block.h"
@@ -58,6 +61,7 @@
 #include "submap.h"
 #include "talker.h"
 #include "teleport.h"
+#include "thread_pool.h"
 #include "translation.h"
 #include "translations.h"
 #include "type_id.h"
@@ -163,8 +167,13 @@ int map::burn_body_part( Character &you, field_entry &cur, const bodypart_id &bp
 
 void map::process_fields()
 {
+    std::vector<gas_source> gas_sources;
+    pending_gas_sources = &gas_sources;
     for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
         auto &field_cache = get_cache( z ).field_cache;
+        if( field_cache.none() ) {
+            continue;
+        }
         for( int x = 0; x < my_MAPSIZE; x++ ) {
             for( int y = 0; y < my_MAPSIZE; y++ ) {
                 if( field_cache[ x + y * MAPSIZE ] ) {
@@ -181,6 +190,8 @@ void map::process_fields()
             }
         }
     }
+    pending_gas_sources = nullptr;
+    spread_gas_sources( gas_sources );
 }
 
 bool ter_furn_has_flag( const ter_t &ter, const furn_t &furn, const ter_furn_flag flag )
@@ -276,13 +287,6 @@ void map::gas_spread_to( field_entry &cur, maptile &dst, const tripoint_bub_ms &
 void map::spread_gas( field_entry &cur, const tripoint_bub_ms &p, int percent_spread,
                       const time_duration &outdoor_age_speedup, scent_block &sblk, const oter_id &om_ter )
 {
-    const bool sheltered = g->is_sheltered( p );
-    weather_manager &weather = get_weather();
-    const int winddirection = weather.winddirection;
-    const int windpower = get_local_windpower( weather.windspeed, om_ter, get_abs( p ),
-                          winddirection,
-                          sheltered );
-
     const int current_intensity = cur.get_field_intensity();
     const field_type_id ft_id = cur.get_field_type();
 
@@ -302,10 +306,61 @@ void map::spread_gas( field_entry &cur, const tripoint_bub_ms &p, int percent_sp
         cur.set_field_age( current_age + outdoor_age_speedup );
     }
 
-    // Bail out if we don't meet the spread chance or required intensity.
-    if( current_intensity <= 1 || rng( 1, 100 - windpower ) > percent_spread ) {
+    if( current_intensity <= 1 ) {
         return;
     }
+    const bool sheltered = g->is_sheltered( p );
+    const weather_manager &weather = get_weather();
+    const int windpower = get_local_windpower( weather.windspeed, om_ter, get_abs( p ),
+                          weather.winddirection, sheltered );
+    const gas_source source{ p, ft_id, percent_spread, sheltered, windpower };
+    if( pending_gas_sources != nullptr ) {
+        pending_gas_sources->push_back( source );
+    } else {
+        spread_gas_sources( { source } );
+    }
+}
+
+// The rng() family of functions draws from the global engine, which can't be shared between
+// threads.  These draw from the given one instead.
+static int rng_from( cata_default_random_engine &engine, int lo, int hi )
+{
+    if( lo > hi ) {
+        std::swap( lo, hi );
+    }
+    return std::uniform_int_distribution<int>( lo, hi )( engine );
+}
+
+static bool one_in_from( cata_default_random_engine &engine, int chance )
+{
+    return chance <= 1 || rng_from( engine, 0, chance - 1 ) == 0;
+}
+
+template<typename T>
+static const T &random_entry_from( cata_default_random_engine &engine,
+                                   const std::vector<T> &container )
+{
+    return container[rng_from( engine, 0, container.size() - 1 )];
+}
+
+std::optional<tripoint_bub_ms> map::pick_gas_move( const gas_source &source,
+        cata_default_random_engine &engine )
+{
+    const tripoint_bub_ms &p = source.p;
+    field_entry *const found = maptile_at_internal( p ).find_field( source.type );
+    if( found == nullptr ) {
+        return std::nullopt;
+    }
+    field_entry &cur = *found;
+    const bool sheltered = source.sheltered;
+    const int winddirection = get_weather().winddirection;
+    const int windpower = source.windpower;
+
+    // Bail out if we don't meet the spread chance or required intensity.
+    if( cur.get_field_intensity() <= 1 ||
+        rng_from( engine, 1, 100 - windpower ) > source.percent_spread ) {
+        return std::nullopt;
+    }
 
     // First check if we can fall
     // TODO: Make fall and rise chances parameters to enable heavy/light gas
@@ -313,13 +368,12 @@ void map::spread_gas( field_entry &cur, const tripoint_bub_ms &p, int percent_sp
         const tripoint_bub_ms down = p + tripoint_rel_ms::below;
         maptile down_tile = maptile_at_internal( down );
         if( gas_can_spread_to( cur, down_tile ) && valid_move( p, down, true, true ) ) {
-            gas_spread_to( cur, down_tile, down );
-            return;
+            return down;
         }
     }
 
     auto neighs = get_neighbors( p );
-    size_t end_it = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
+    size_t end_it = static_cast<size_t>( rng_from( engine, 0, neighs.size() - 1 ) );
     std::vector<size_t> spread;
     // Then, spread to a nearby point.
     // If not possible (or randomly), try to spread up
@@ -334,11 +388,10 @@ void map::spread_gas( field_entry &cur, const tripoint_bub_ms &p, int percent_sp
         }
     }
 
-    if( !spread.empty() && one_in( spread.size() ) ) {
+    if( !spread.empty() && one_in_from( engine, spread.size() ) ) {
         // Construct the destination from offset and p
         if( sheltered || windpower < 5 ) {
-            std::pair<tripoint_bub_ms, maptile> &n = neighs[ random_entry( spread ) ];
-            gas_spread_to( cur, n.second, n.first );
+            return neighs[ random_entry_from( engine, spread ) ].first;
         } else {
             std::vector<size_t> neighbour_vec;
             auto maptiles = get_wind_blockers( winddirection, p );
@@ -351,20 +404,70 @@ void map::spread_gas( field_entry &cur, const tripoint_bub_ms &p, int percent_sp
                 if( ( neigh.pos_ != remove_tile.pos_ &&
                       neigh.pos_ != remove_tile2.pos_ &&
                       neigh.pos_ != remove_tile3.pos_ ) ||
-                    x_in_y( 1, std::max( 2, windpower ) ) ) {
+                    one_in_from( engine, std::max( 2, windpower ) ) ) {
                     neighbour_vec.push_back( i );
                 }
             }
             if( !neighbour_vec.empty() ) {
-                std::pair<tripoint_bub_ms, maptile> &n = neighs[ random_entry( neighbour_vec ) ];
-                gas_spread_to( cur, n.second, n.first );
+                return neighs[ random_entry_from( engine, neighbour_vec ) ].first;
             }
         }
     } else if( p.z() < OVERMAP_HEIGHT ) {
         const tripoint_bub_ms up = p + tripoint_rel_ms::above;
         maptile up_tile = maptile_at_internal( up );
         if( gas_can_spread_to( cur, up_tile ) && valid_move( p, up, true, true ) ) {
-            gas_spread_to( cur, up_tile, up );
+            return up;
+        }
+    }
+    return std::nullopt;
+}
+
+void map::spread_gas_sources( const std::vector<gas_source> &sources )
+{
+    if( sources.empty() ) {
+        return;
+    }
+    // The sources come a submap at a time, and each submap is a task.
+    std::vector<size_t> task_starts;
+    for( size_t i = 0; i < sources.size(); ++i ) {
+        if( i == 0 || coords::project_to<coords::sm>( sources[i].p ) !=
+            coords::project_to<coords::sm>( sources[i - 1].p ) ) {
+            task_starts.push_back( i );
+        }
+    }
+    task_starts.push_back( sources.size() );
+
+    // Nothing changes the fields while the moves are picked, so every source sees them as the
+    // pass left them.  The moves are applied afterwards.  Each square draws from its own engine,
+    // seeded from its position and one draw from the global engine, so the outcome doesn't
+    // depend on which thread picked it, or in what order.
+    const unsigned int pass_seed = rng_bits();
+    std::vector<std::optional<tripoint_bub_ms>> moves( sources.size() );
+    get_thread_pool().parallel_for( task_starts.size() - 1, [&]( const size_t task ) {
+        for( size_t i = task_starts[task]; i < task_starts[task + 1]; ++i ) {
+            const tripoint_abs_ms abs_p = get_abs( sources[i].p );
+            size_t seed = pass_seed;
+            cata::hash_combine( seed, abs_p.x() );
+            cata::hash_combine( seed, abs_p.y() );
+            cata::hash_combine( seed, abs_p.z() );
+            cata::hash_combine( seed, sources[i].type.to_i() );
+            cata_default_random_engine engine( static_cast<unsigned int>( seed ) );
+            moves[i] = pick_gas_move( sources[i], engine );
+        }
+    } );
+
+    for( size_t i = 0; i < sources.size(); ++i ) {
+        if( !moves[i] ) {
+            continue;
+        }
+        field_entry *cur = get_field( sources[i].p, sources[i].type );
+        // Earlier moves may have thinned out the source or filled up the destination.
+        if( cur == nullptr || cur->get_field_intensity() <= 1 ) {
+            continue;
+        }
+        maptile dst_tile = maptile_at( *moves[i] );
+        if( gas_can_spread_to( *cur, dst_tile ) ) {
+            gas_spread_to( *cur, dst_tile, *moves[i] );
         }
     }
 }
@@ -422,6 +525,7 @@ If you need to insert a new field behavior per unit time add a case statement in
 void map::process_fields_in_submap( submap *const current_submap,
                                     const tripoint_bub_sm &submap )
 {
+    CATA_TIMER_SCOPE( "map::process_fields_in_submap" );
     const oter_id &om_ter = overmap_buffer.ter( coords::project_to<coords::omt>(
                                 abs_sub + rebase_rel( submap ) ) );
     Character &player_character = get_player_character();
@@ -443,9 +547,20 @@ void map::process_fields_in_submap( submap *const current_submap,
         &( *fd_null )
     };
 
-    // Loop through all tiles in this submap indicated by current_submap
+    std::bitset<SEEX *SEEY> &field_squares = current_submap->get_field_squares();
+    if( field_squares.none() && current_submap->field_count > 0 ) {
+        // Fields were put here without marking their squares, fall back to looking at all of them.
+        field_squares.set();
+    }
+
+    // Loop through the tiles of this submap that may have fields.  Fields spreading to squares
+    // further on are processed in this same pass, just like when every square was visited.
     for( locx = 0; locx < SEEX; locx++ ) {
         for( locy = 0; locy < SEEY; locy++ ) {
+            const size_t square = locx * SEEY + locy;
+            if( !field_squares[square] ) {
+                continue;
+            }
             // Get a reference to the field variable from the submap;
             // contains all the pointers to the real field effects.
             field &curfield = current_submap->get_field( { static_cast<int>( locx ), static_cast<int>( locy ) } );
@@ -453,6 +568,11 @@ void map::process_fields_in_submap( submap *const current_submap,
             // when displayed_field_type == fd_null it means that `curfield` has no fields inside
             // avoids instantiating (relatively) expensive map iterator
             if( !curfield.displayed_field_type() ) {
+                if( curfield.field_count() == 0 ) {
+                    // Frees what the fields that were here left behind
+                    curfield.clear();
+                    field_squares.reset( square );
+                }
                 continue;
             }
 
@@ -495,6 +615,10 @@ void map::process_fields_in_submap( submap *const current_submap,
                 }
                 ++it;
             }
+            if( curfield.field_count() == 0 ) {
+                curfield.clear();
+                field_squares.reset( square );
+            }
         }
     }
     sblk.commit_modifications();
@@ -2149,6 +2273,27 @@ void map::emit_field( const tripoint_bub_ms &pos, const emit_id &src, float mul
     }
 }
 
+void map::emit_fields_due()
+{
+    const int slot = to_turns<int>( calendar::turn - calendar::turn_zero ) % emitter_period;
+    // Emitting can replace furniture or terrain and so add emitters, which are indexed here
+    // because that may grow the list being walked.
+    const std::vector<tripoint_bub_ms> &furn_locs = field_furn_locs[slot];
+    for( size_t i = 0; i < furn_locs.size(); ++i ) {
+        const tripoint_bub_ms p = furn_locs[i];
+        for( const emit_id &e : furn( p )->emissions ) {
+            emit_field( p, e );
+        }
+    }
+    const std::vector<tripoint_bub_ms> &ter_locs = field_ter_locs[slot];
+    for( size_t i = 0; i < ter_locs.size(); ++i ) {
+        const tripoint_bub_ms p = ter_locs[i];
+        for( const emit_id &e : ter( p )->emissions ) {
+            emit_field( p, e );
+        }
+    }
+}
+
 void map::propagate_field( const tripoint_bub_ms &center, const field_type_id &type, int amount,
                            int max_intensity )
 {
@@ -2265,13 +2265,11 @@ bool talk_function::companion_om_combat_check( const std::vector<npc_ptr> &group
             overmap &omi = overmap_buffer.get( omp );
 
             // TODO: Interact with dormant horde monsters as well?
-            for( std::unordered_map<tripoint_abs_ms, horde_entity> *bucket :
-                 omi.hordes.entity_group_at( local_omt ) ) {
-                for( std::pair<const tripoint_abs_ms, horde_entity> &monster_entry : *bucket ) {
+            for( horde_chunk *bucket : omi.hordes.entity_group_at( local_omt ) ) {
+                for( const horde_entity_ref monster_entry : *bucket ) {
                     // TODO: figure out hwat to do if this involves lightweight horde entities?
-                    if( monster_entry.second.monster_data ) {
-                        monster &this_monster = *monster_entry.second.monster_data;
-                        monsters_around.push_back( &this_monster );
+                    if( monster *this_monster = monster_entry.monster_data() ) {
+                        monsters_around.push_back( this_monster );
                     }
                 }
             }
@@ -40,6 +40,7 @@
 #include "npc.h"
 #include "options.h"
 #include "pathfinding.h"
+#include "perf.h"
 #include "pimpl.h"
 #include "point.h"
 #include "rng.h"
@@ -509,6 +510,7 @@ bool monster::mating_angry() const
 
 void monster::plan()
 {
+    CATA_TIMER_SCOPE( "monster::plan" );
     monster_plan mon_plan( *this );
 
     map &here = get_map();
@@ -541,8 +543,9 @@ void monster::plan()
         anger_cub_threatened( mon_plan );
     } else if( friendly != 0 && !mon_plan.docile ) {
         for( monster &tmp : g->all_monsters() ) {
-            if( tmp.friendly == 0 && tmp.attitude_to( *this ) == Attitude::HOSTILE &&
-                seen_levels.test( tmp.posz() + OVERMAP_DEPTH ) ) {
+            // attitude_to() is the expensive check, leave it for last
+            if( tmp.friendly == 0 && seen_levels.test( tmp.posz() + OVERMAP_DEPTH ) &&
+                tmp.attitude_to( *this ) == Attitude::HOSTILE ) {
                 float rating = rate_target( tmp, mon_plan.dist, mon_plan.smart_planning );
                 if( rating < mon_plan.dist ) {
                     mon_plan.target = &tmp;
@@ -5310,8 +5310,8 @@ void npc::set_omt_destination()
         }
         omt_path.clear();
         if( !goal.is_invalid() ) {
-            omt_path = overmap_buffer.get_travel_path( surface_omt_loc, goal,
-                       overmap_path_params::for_npc() ).points;
+            omt_path = overmap_buffer.get_cached_travel_path( surface_omt_loc, goal,
+                       overmap_path_params::for_npc() );
         }
         if( !omt_path.empty() ) {
             dest_type = overmap_buffer.ter( goal )->get_type_id().str();
@@ -2886,6 +2886,13 @@ void options_manager::add_options_debug()
 
     add_empty_line();
 
+    add( "HORDE_MOVE_BUDGET", "debug", to_translation( "Overmap horde move budget" ),
+         to_translation( "Number of horde entity moves simulated on each overmap every turn, rounded up to whole submaps.  Hordes that don't get to move catch up on a later turn, for at most a minute.  0 means no limit." ),
+         0, 100000, 1000
+       );
+
+    add_empty_line();
+
 #ifndef NO_STALE_DATA_WARN
     add( "WARN_ON_MODIFIED", "debug", to_translation( "Warn if file integrity check fails" ),
          to_translation( "This option controls whether the game will warn when it detects that the game's data has been modified." ),
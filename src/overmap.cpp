@@ -370,6 +370,9 @@ void overmap::ter_set( const tripoint_om_omt &p, const oter_id &id )
     }
     // TODO: maaaaybe this can be set after underlying map data has been changed? IDK.
     set_passable( project_combine( loc, p ), id->get_type_id()->default_map_data );
+    if( current_oter != id ) {
+        overmap_buffer.terrain_changed();
+    }
     current_oter = id;
 }
 
@@ -776,21 +779,23 @@ void overmap::add_omt_stack_argument( const point_abs_omt &p, const std::string
 }
 
 bool overmap::passable( const tripoint_om_ms &p )
+{
+    return terrain_passable( p ) && !hordes.entity_at( p );
+}
+
+bool overmap::terrain_passable( const tripoint_om_ms &p ) const
 {
     point_om_omt omt_origin;
     tripoint_omt_ms index;
     std::tie( omt_origin, index ) = project_remain<coords::omt>( p );
-    std::shared_ptr<map_data_summary> &ptr = layer[index.z() +
+    const std::shared_ptr<map_data_summary> &ptr = layer[index.z() +
             OVERMAP_DEPTH].map_cache[omt_origin];
     if( !ptr ) {
         // Oh no we aren't populated???
         // Promote to error later.
         return false;
     }
-    if( !ptr->passable[index.y() * 24 + index.x()] ) {
-        return false;
-    }
-    return hordes.entity_at( p ) == nullptr;
+    return ptr->passable[index.y() * 24 + index.x()];
 }
 
 std::shared_ptr<map_data_summary> overmap::get_omt_summary( const tripoint_om_omt &p )
@@ -1466,9 +1471,9 @@ void mongroup::wander( const overmap &om )
     }
 }
 
-horde_entity &overmap::spawn_monster( const tripoint_abs_ms &p, mtype_id id )
+std::optional<horde_entity_ref> overmap::spawn_monster( const tripoint_abs_ms &p, mtype_id id )
 {
-    return ( *hordes.spawn_entity( p, id ) )->second;
+    return hordes.spawn_entity( p, id );
 }
 
 // Seeks through the submap looking for open areas.
@@ -1529,110 +1534,222 @@ void overmap::spawn_mongroup( const tripoint_om_sm &p, const mongroup_id &type,
     }
 }
 
-horde_entity *overmap::entity_at( const tripoint_om_ms &p )
+std::optional<horde_entity_ref> overmap::entity_at( const tripoint_om_ms &p )
 {
     return hordes.entity_at( p );
 }
 
 // This should really be const but I don't want to mess with it right now.
-std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> overmap::hordes_at(
-    const tripoint_om_omt &p, int filter )
+std::vector<horde_chunk *> overmap::hordes_at( const tripoint_om_omt &p, int filter )
 {
     return hordes.entity_group_at( p, filter );
 }
 
 /**
  * Moves hordes around the map according to their behaviour and target.
- * If they enter the coordinate space of the loaded map, spawn them there.
+ * Entities that enter the coordinate space of the loaded map are spawned there, and ones
+ * that wander onto another overmap move to it, both in finish_horde_move().
+ * The submaps holding active entities are processed in sweeps that can span several turns
+ * when there are too many of them to handle before the deadline, entities that had to wait
+ * catch up on the turns they missed once their submap comes up.
  */
-void overmap::move_hordes()
-{
-    // TODO: throttle processing of monsters.
-    // Specifically for throttling, only a process a subset of the eligible monster buckets per invocation.
-    std::unordered_map<tripoint_abs_ms, horde_entity> migrating_hordes;
-    for( horde_map::iterator mon = hordes.get_view( horde_map_flavors::active ).begin(),
-         mon_end = hordes.end(); mon != mon_end; ) {
-        // This might have an issue where a monster prevented from acting possibly should
-        // get another chance to act?
-        // This is here so that when a entity moves from one bucket to another it doesn't
-        // get a second set of moves.
-        if( mon->second.last_processed == calendar::turn ) {
-            mon++;
-            continue;
+// The most turns a horde entity catches up on when its submap comes up.
+static constexpr time_duration horde_catch_up_limit = 1_minutes;
+
+void overmap::move_hordes( int budget, const horde_neighbors &neighbors,
+                           std::vector<horde_move> &leaving )
+{
+    if( horde_schedule.empty() ) {
+        horde_schedule = hordes.active_submaps();
+        // Sorted for a stable processing order, back to front.
+        std::sort( horde_schedule.rbegin(), horde_schedule.rend() );
+        // The first sweep has nothing to catch up on, and neither does one after the
+        // calendar was turned back.
+        previous_horde_sweep_start = std::min( horde_sweep_start.value_or( calendar::turn ),
+                                               calendar::turn ) - 1_turns;
+        horde_sweep_start = calendar::turn;
+    }
+    // Every submap was processed at least once since the previous sweep started, so that is
+    // as far back as catching up goes.  An entity that fell further behind than the limit
+    // loses the extra turns, which keeps a sweep from growing longer and longer when the
+    // budget can't keep up with the number of entities.
+    const time_point catch_up_floor = std::max( previous_horde_sweep_start,
+                                      calendar::turn - horde_catch_up_limit );
+    int work = 0;
+    std::vector<std::pair<tripoint_abs_ms, horde_entity>> migrating_hordes;
+    while( !horde_schedule.empty() ) {
+        const tripoint_om_sm next_submap = horde_schedule.back();
+        horde_schedule.pop_back();
+        work += move_horde_chunk( next_submap, catch_up_floor, neighbors, migrating_hordes, leaving );
+        for( std::pair<tripoint_abs_ms, horde_entity> &migrating : migrating_hordes ) {
+            // Entities still owed turns catch up on them in this sweep, waiting for the next
+            // one could take them past the catch up floor.
+            const tripoint_om_sm dest_sm = project_remain<coords::om>( project_to<coords::sm>
+                                           ( migrating.first ) ).remainder_tripoint;
+            if( migrating.second.last_processed < calendar::turn &&
+                std::find( horde_schedule.begin(), horde_schedule.end(),
+                           dest_sm ) == horde_schedule.end() ) {
+                horde_schedule.push_back( dest_sm );
+            }
+            hordes.insert( migrating.first, std::move( migrating.second ) );
+        }
+        migrating_hordes.clear();
+        // Submaps are never split, so some progress is always made however small the budget.
+        if( budget > 0 && work >= budget ) {
+            break;
         }
-        mon->second.last_processed = calendar::turn;
-        // If we have a goal, proceed toward it.
-        if( mon->second.tracking_intensity > 0 && mon->first != mon->second.destination ) {
-            mon->second.tracking_intensity--;
-            mon->second.moves += mon->second.type_id->speed;
-            if( mon->second.moves <= 0 ) {
-                mon++;
+    }
+}
+
+int overmap::move_horde_chunk( const tripoint_om_sm &p, const time_point &catch_up_floor,
+                               const horde_neighbors &neighbors,
+                               std::vector<std::pair<tripoint_abs_ms, horde_entity>> &migrating_hordes,
+                               std::vector<horde_move> &leaving )
+{
+    horde_chunk *chunk = hordes.active_chunk( p );
+    if( chunk == nullptr ) {
+        return 0;
+    }
+    int work = 0;
+    for( size_t index = 0; index < chunk->size(); ) {
+        const horde_entity_ref mon = ( *chunk )[index];
+        bool left_chunk = false;
+        // Entities that moved here from a submap processed earlier have already had their
+        // turn, this is also what keeps them from getting a second set of moves.
+        // The calendar can be turned back, don't hold entities up until it catches up.
+        const time_point last_processed = std::min( mon.last_processed(), calendar::turn );
+        for( time_point next_turn = std::max( last_processed, catch_up_floor ) + 1_turns;
+             next_turn <= calendar::turn; next_turn += 1_turns ) {
+            ++work;
+            mon.set_last_processed( next_turn );
+            const tripoint_abs_ms mon_pos = mon.pos();
+            const tripoint_abs_ms destination = mon.destination();
+            // If we have a goal, proceed toward it.
+            if( mon.tracking_intensity() <= 0 || mon_pos == destination ) {
+                mon.set_last_processed( calendar::turn );
+                break;
+            }
+            mon.set_tracking_intensity( mon.tracking_intensity() - 1 );
+            mon.set_moves( mon.moves() + mon.type_id()->speed );
+            if( mon.moves() <= 0 ) {
                 continue;
             }
             std::vector<tripoint_abs_ms> viable_candidates;
-            // Call up to overmapbuffer in case it needs to dispatch to an adjacent overmap.
-            for( const tripoint_abs_ms &candidate :
-                 squares_closer_to( mon->first, mon->second.destination ) ) {
+            for( const tripoint_abs_ms &candidate : squares_closer_to( mon_pos, destination ) ) {
                 // Just filter out cross-level candidates for now.
-                if( candidate.z() == mon->first.z() && overmap_buffer.passable( candidate ) ) {
+                if( candidate.z() == mon_pos.z() && horde_passable( candidate, neighbors ) ) {
                     viable_candidates.push_back( candidate );
                 }
             }
             if( viable_candidates.empty() ) {
                 // We're stuck.
                 // TODO: try to wander to get around obstacles, or smash.
-                mon++;
                 continue;
             }
-            // TODO: nuanced move costs.
-            mon->second.moves -= 100;
-            if( viable_candidates.front() == mon->second.destination ) {
-                mon->second.tracking_intensity = 0;
-            }
             // squares_closer_to already orders candidates by how close to the main line they are.
             // For now just pick the first non-blocked square, later we could fuzz/stumble.
-            if( get_map().inbounds( viable_candidates.front() ) ) {
-                monster *placed_monster = nullptr;
-                if( mon->second.monster_data ) {
-                    placed_monster = g->place_critter_around( make_shared_fast<monster>( *mon->second.monster_data ),
-                                     get_map().get_bub( viable_candidates.front() ), 1 );
-                } else {
-                    placed_monster = g->place_critter_around( mon->second.type_id->id,
-                                     get_map().get_bub( viable_candidates.front() ), 1 );
-                }
-                if( placed_monster == nullptr ) {
-                    // If the tile is occupied it can't enter, just don't move for now.
-                    mon++;
-                    continue;
-                }
-                // TODO: this should be bundled into a constructor.
-                if( mon->second.tracking_intensity > 0 ) {
-                    placed_monster->wander_to( mon->second.destination, mon->second.tracking_intensity );
-                }
-                mon = hordes.erase( mon );
-                continue;
+            const tripoint_abs_ms next_pos = viable_candidates.front();
+            if( get_map().inbounds( next_pos ) ||
+                project_to<coords::om>( next_pos ).xy() != loc ) {
+                // The entity stays put until the move is made, which is when its moves are spent.
+                // Any turns it is still owed are caught up on wherever it ends up.
+                leaving.push_back( { mon_pos, std::move( viable_candidates ) } );
+                break;
             }
+            // TODO: nuanced move costs.
+            mon.set_moves( mon.moves() - 100 );
+            if( next_pos == destination ) {
+                mon.set_tracking_intensity( 0 );
+            }
+            // Any turns it is still owed are caught up on in the submap it moves to.
+            migrating_hordes.emplace_back( next_pos, hordes.extract( *chunk, index ) );
+            left_chunk = true;
+            break;
+        }
+        // The last entity of the chunk took the place of one that left.
+        if( !left_chunk ) {
+            ++index;
+        }
+    }
+    hordes.prune_chunk( p );
+    return work;
+}
 
-            horde_map::iterator moving_mon = mon;
-            // Advance the loop iterator past the current node, which we will be removing.
-            mon++;
-            auto monster_node = hordes.extract( moving_mon );
-            monster_node.key() = viable_candidates.front();
-            migrating_hordes.insert( std::move( monster_node ) );
+bool overmap::horde_passable( const tripoint_abs_ms &p, const horde_neighbors &neighbors )
+{
+    point_abs_om omp;
+    tripoint_om_ms local;
+    std::tie( omp, local ) = project_remain<coords::om>( p );
+    if( omp == loc ) {
+        return passable( local );
+    }
+    const point offset = omp.raw() - loc.raw();
+    if( std::abs( offset.x ) > 1 || std::abs( offset.y ) > 1 ) {
+        return false;
+    }
+    const overmap *neighbor = neighbors[( offset.y + 1 ) * 3 + offset.x + 1];
+    return neighbor != nullptr && neighbor->terrain_passable( local );
+}
+
+void overmap::finish_horde_move( const horde_move &move )
+{
+    point_abs_om omp;
+    tripoint_om_ms local;
+    std::tie( omp, local ) = project_remain<coords::om>( move.from );
+    horde_map::iterator mon = hordes.find( local );
+    if( mon == hordes.end() ) {
+        debugmsg( "A horde entity was lost before it could move." );
+        return;
+    }
+    const auto spend_move = [&mon]( const tripoint_abs_ms & to ) {
+        // TODO: nuanced move costs.
+        mon->set_moves( mon->moves() - 100 );
+        if( to == mon->destination() ) {
+            mon->set_tracking_intensity( 0 );
         }
+    };
+    if( get_map().inbounds( move.to.front() ) ) {
+        spend_move( move.to.front() );
+        monster *placed_monster = nullptr;
+        if( mon->monster_data() ) {
+            placed_monster = g->place_critter_around( make_shared_fast<monster>( *mon->monster_data() ),
+                             get_map().get_bub( move.to.front() ), 1 );
+        } else {
+            placed_monster = g->place_critter_around( mon->type_id()->id,
+                             get_map().get_bub( move.to.front() ), 1 );
+        }
+        if( placed_monster == nullptr ) {
+            // If the tile is occupied it can't enter, just don't move for now.
+            return;
+        }
+        // TODO: this should be bundled into a constructor.
+        if( mon->tracking_intensity() > 0 ) {
+            placed_monster->wander_to( mon->destination(), mon->tracking_intensity() );
+        }
+        hordes.erase( mon );
+        return;
     }
-    while( !migrating_hordes.empty() ) {
-        auto monster_node = migrating_hordes.extract( migrating_hordes.begin() );
+    // Only the terrain of other overmaps could be checked when the move was chosen. Now that
+    // their entities are settled, take the first candidate that passable() allows, like a move
+    // within the overmap does, or stay stuck without spending any moves if there is none.
+    for( const tripoint_abs_ms &to : move.to ) {
+        if( get_map().inbounds( to ) ) {
+            continue;
+        }
         point_abs_om dest_omp;
-        tripoint_om_sm dest_sm;
-        std::tie( dest_omp, dest_sm ) = project_remain<coords::om>( project_to<coords::sm>
-                                        ( monster_node.key() ) );
-        overmap *dest_om = overmap_buffer.get_existing( dest_omp );
+        tripoint_om_ms dest_local;
+        std::tie( dest_omp, dest_local ) = project_remain<coords::om>( to );
+        overmap *dest_om = dest_omp == loc ? this : overmap_buffer.get_existing( dest_omp );
         if( dest_om == nullptr ) {
             debugmsg( "A horde entity tried to wander into a non-existent overmap." );
             continue;
         }
-        dest_om->hordes.insert( std::move( monster_node ) );
+        if( !dest_om->passable( dest_local ) ) {
+            continue;
+        }
+        spend_move( to );
+        dest_om->hordes.insert( to, hordes.extract( mon ) );
+        return;
     }
 }
 
@@ -1781,11 +1898,16 @@ void overmap::alert_entity( const tripoint_om_ms &location, const tripoint_abs_m
                             int intensity )
 {
     horde_map::iterator target = hordes.find( location );
-    if( target != hordes.end() && intensity > target->second.tracking_intensity ) {
-        auto monster_node = hordes.extract( target );
-        monster_node.mapped().tracking_intensity = intensity;
-        monster_node.mapped().destination = destination;
-        hordes.insert( std::move( monster_node ) );
+    if( target != hordes.end() && intensity > target->tracking_intensity() ) {
+        const tripoint_abs_ms entity_pos = target->pos();
+        horde_entity entity = hordes.extract( target );
+        if( !entity.is_active() ) {
+            // Don't let a long idle entity catch up on the time it had nowhere to go.
+            entity.last_processed = std::max( entity.last_processed, calendar::turn - 1_turns );
+        }
+        entity.tracking_intensity = intensity;
+        entity.destination = destination;
+        hordes.insert( entity_pos, std::move( entity ) );
     }
 }
 
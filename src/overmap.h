@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "basecamp.h"
+#include "calendar.h"
 #include "catacharset.h"
 #include "cata_variant.h"
 #include "city.h"
@@ -57,7 +58,6 @@ class character_id;
 class monster;
 class npc;
 class overmap_connection;
-struct horde_entity;
 struct map_data_summary;
 struct region_settings;
 template <typename T> struct enum_traits;
@@ -153,6 +153,14 @@ size_t from_dir( om_direction::type dir );
 
 } // namespace om_lines
 
+// A horde entity about to leave the horde_map of its overmap, see overmap::move_hordes().
+struct horde_move {
+    tripoint_abs_ms from;
+    // The squares it could step onto, best first.  Only the first one is used when entering
+    // the reality bubble, the rest are fallbacks for squares on another overmap found occupied.
+    std::vector<tripoint_abs_ms> to;
+};
+
 struct om_vehicle {
     tripoint_om_omt p; // overmap coordinates of tracked vehicle
     std::string name;
@@ -519,6 +527,8 @@ class overmap
          * Access cache of map data for agents operating at overmap scale.
          */
         bool passable( const tripoint_om_ms &p );
+        // Like passable(), but ignoring horde entities.
+        bool terrain_passable( const tripoint_om_ms &p ) const;
         std::shared_ptr<map_data_summary> get_omt_summary( const tripoint_om_omt &p );
         void set_passable( const tripoint_om_ms &p, bool new_passable );
         void set_passable( const tripoint_abs_omt &p, const std::bitset<24 * 24> &new_passable );
@@ -529,14 +539,13 @@ class overmap
                 point_rel_ms &cursor );
     public:
         // Spawn a monter at overmap scale.
-        horde_entity &spawn_monster( const tripoint_abs_ms &p, mtype_id id );
+        std::optional<horde_entity_ref> spawn_monster( const tripoint_abs_ms &p, mtype_id id );
         // Spawn a vector of monsters at overmap scale on a specified submap.
         void spawn_monsters( const tripoint_om_sm &p, std::vector<monster> &monsters );
         // Spawn monsters from a mongroup on a specified submap.
         void spawn_mongroup( const tripoint_om_sm &p, const mongroup_id &type, int count );
-        horde_entity *entity_at( const tripoint_om_ms &p );
-        std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> hordes_at(
-            const tripoint_om_omt &p, int filter );
+        std::optional<horde_entity_ref> entity_at( const tripoint_om_ms &p );
+        std::vector<horde_chunk *> hordes_at( const tripoint_om_omt &p, int filter );
 
         /**
          * Getter for overmap scents.
@@ -658,6 +667,11 @@ class overmap
         point_abs_om loc; // NOLINT(cata-serialize)
         // Random point used for special connections if there's no cities on the overmap, joins to all roads_out
         std::optional<point_om_omt> fallback_road_connection_point; // NOLINT(cata-serialize)
+        // Submaps with active horde entities left to process in the current sweep, last one first.
+        std::vector<tripoint_om_sm> horde_schedule; // NOLINT(cata-serialize)
+        // When the current sweep over the hordes started, and when the one before it did.
+        std::optional<time_point> horde_sweep_start; // NOLINT(cata-serialize)
+        time_point previous_horde_sweep_start; // NOLINT(cata-serialize)
 
         // Whether this overmap has a highway connection point at this direction (N/E/S/W)
         std::array<tripoint_om_omt, 4> highway_connections = {
@@ -750,7 +764,26 @@ class overmap
         void alert_entity( const tripoint_om_ms &location, const tripoint_abs_ms &destination,
                            int intensity );
         void process_mongroups();
-        void move_hordes();
+        // This overmap and the ones around it, indexed by ( y + 1 ) * 3 + x + 1 for an offset of
+        // x and y overmaps. Null where there is no overmap.
+        using horde_neighbors = std::array<const overmap *, 9>;
+        // Moves the active horde entities of submaps until budget entity turns were simulated,
+        // finishing the submap it is in and resuming with the next one on the following call.
+        // 0 means no limit.
+        // Overmaps can move their hordes in parallel, so this only modifies the overmap itself:
+        // entities entering the reality bubble or another overmap are left where they are and
+        // their move is queued in leaving, to be made with finish_horde_move() afterwards.
+        void move_hordes( int budget, const horde_neighbors &neighbors,
+                          std::vector<horde_move> &leaving );
+        // Returns the number of entity turns simulated.
+        int move_horde_chunk( const tripoint_om_sm &p, const time_point &catch_up_floor,
+                               const horde_neighbors &neighbors,
+                               std::vector<std::pair<tripoint_abs_ms, horde_entity>> &migrating_hordes,
+                               std::vector<horde_move> &leaving );
+        // Whether an entity of this overmap can step onto p. Only the terrain is checked on
+        // the other overmaps, their entities may be moving, finish_horde_move() checks them.
+        bool horde_passable( const tripoint_abs_ms &p, const horde_neighbors &neighbors );
+        void finish_horde_move( const horde_move &move );
 
         //nemesis movement for "hunted" trait
         void signal_nemesis( const tripoint_abs_sm & );
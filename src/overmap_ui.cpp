@@ -384,21 +384,20 @@ void overmap_sidebar::draw_debug()
             }
         }
 
-        std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> hordes =
-            overmap_buffer.hordes_at( cursor_pos );
+        std::vector<horde_chunk *> hordes = overmap_buffer.hordes_at( cursor_pos );
 
         if( !hordes.empty() ) {
             int horde_size = 0;
-            for( std::unordered_map<tripoint_abs_ms, horde_entity> *horde : hordes ) {
+            for( horde_chunk *horde : hordes ) {
                 horde_size += horde->size();
-                for( std::pair<const tripoint_abs_ms, horde_entity> &entity : *horde ) {
-                    const mtype *horde_type = entity.second.get_type();
+                for( const horde_entity_ref entity : *horde ) {
+                    const mtype *horde_type = entity.get_type();
                     ImGui::Indent();
                     draw_sidebar_text( string_format( "Species: %s", horde_type->nname() ), c_blue );
-                    draw_sidebar_text( string_format( "Interest: %d", entity.second.tracking_intensity ),
+                    draw_sidebar_text( string_format( "Interest: %d", entity.tracking_intensity() ),
                                        c_blue );
                     draw_sidebar_text( string_format( "Target: %s",
-                                                      entity.second.destination.to_string() ), c_blue );
+                                                      entity.destination().to_string() ), c_blue );
                     ImGui::Unindent();
                     //mvwprintz(wbar, desc_pos + point(0, line_number++), c_red, "x"); ???
                 }
@@ -1117,8 +1116,7 @@ static void draw_ascii( const catacurses::window &w, overmap_draw_data_t &data )
             // Are we debugging monster groups?
             if( blink && uistate.overmap_debug_mongroup ) {
                 // TODO Check if this tile is a target of the currently highlighted horde.
-                std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> hordes = overmap_buffer.hordes_at(
-                            omp );
+                std::vector<horde_chunk *> hordes = overmap_buffer.hordes_at( omp );
                 if( !hordes.empty() ) {
                     ter_sym = "+";
                 } else {
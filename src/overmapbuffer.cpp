@@ -10,6 +10,9 @@
 #include <optional>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "basecamp.h"
 #include "calendar.h"
@@ -50,6 +53,7 @@
 #include "simple_pathfinding.h"
 #include "string_formatter.h"
 #include "text.h"
+#include "thread_pool.h"
 #include "translations.h"
 #include "vehicle.h"
 #include "worldfactory.h"
@@ -254,6 +258,7 @@ void overmapbuffer::save()
 void overmapbuffer::reset()
 {
     overmaps.clear();
+    travel_paths.clear();
     global_state.highway_intersections.clear();
     last_requested_overmap = nullptr;
 }
@@ -261,6 +266,7 @@ void overmapbuffer::reset()
 void overmapbuffer::clear()
 {
     overmaps.clear();
+    travel_paths.clear();
     known_non_existing.clear();
     global_state.clear();
     last_requested_overmap = nullptr;
@@ -517,9 +523,8 @@ bool overmapbuffer::has_horde( const tripoint_abs_omt &p )
 int overmapbuffer::get_horde_size( const tripoint_abs_omt &p, int filter )
 {
     int horde_size = 0;
-    std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> hordes = overmap_buffer.hordes_at(
-                p, filter );
-    for( std::unordered_map<tripoint_abs_ms, horde_entity> *horde_group : hordes ) {
+    std::vector<horde_chunk *> hordes = overmap_buffer.hordes_at( p, filter );
+    for( horde_chunk *horde_group : hordes ) {
         horde_size += horde_group->size();
     }
 
@@ -717,11 +722,31 @@ void overmapbuffer::process_mongroups()
 
 void overmapbuffer::move_hordes()
 {
+    const int budget = get_option<int>( "HORDE_MOVE_BUDGET" );
     // arbitrary radius to include nearby overmaps (aside from the current one)
     const int radius = MAPSIZE * 2;
     const tripoint_abs_sm center = get_player_character().pos_abs_sm();
-    for( overmap *&om : get_overmaps_near( center, radius ) ) {
-        om->move_hordes();
+    const std::vector<overmap *> nearby = get_overmaps_near( center, radius );
+    // Loading overmaps isn't thread safe, so look up every overmap the hordes could step onto
+    // before they start moving.
+    std::vector<overmap::horde_neighbors> neighbors( nearby.size() );
+    for( size_t i = 0; i < nearby.size(); ++i ) {
+        for( int y = -1; y <= 1; ++y ) {
+            for( int x = -1; x <= 1; ++x ) {
+                neighbors[i][( y + 1 ) * 3 + x + 1] = get_existing( nearby[i]->pos() + point( x, y ) );
+            }
+        }
+    }
+    std::vector<std::vector<horde_move>> leaving( nearby.size() );
+    get_thread_pool().parallel_for( nearby.size(), [&]( size_t i ) {
+        nearby[i]->move_hordes( budget, neighbors[i], leaving[i] );
+    } );
+    // Moves into the reality bubble and across overmaps are made in a fixed order, so the
+    // result doesn't depend on how the overmaps were split between threads.
+    for( size_t i = 0; i < nearby.size(); ++i ) {
+        for( const horde_move &move : leaving[i] ) {
+            nearby[i]->finish_horde_move( move );
+        }
     }
 }
 
@@ -1067,13 +1092,9 @@ static bool is_ramp( const tripoint_abs_omt &omt_pos )
            ( oter->get_type_id() == oter_type_bridgehead_ramp );
 }
 
-pf::simple_path<tripoint_abs_omt> overmapbuffer::get_travel_path(
-    const tripoint_abs_omt &src, const tripoint_abs_omt &dest, const overmap_path_params &params )
+static pf::simple_path<tripoint_abs_omt> find_travel_path( const tripoint_abs_omt &src,
+        const tripoint_abs_omt &dest, const overmap_path_params &params, const int radius )
 {
-    if( src.is_invalid() || dest.is_invalid() ) {
-        return {};
-    }
-
     const pf::omt_scoring_fn estimate = [&]( tripoint_abs_omt pos ) {
         int cur_cost = get_terrain_cost( pos, params );
         if( cur_cost < 0 ) {
@@ -1086,10 +1107,129 @@ pf::simple_path<tripoint_abs_omt> overmapbuffer::get_travel_path(
         return pf::omt_score( cur_cost, is_ramp( pos ) );
     };
 
+    return pf::find_overmap_path( src, dest, radius, estimate, g->display_om_pathfinding_progress,
+                                  std::nullopt, params.allow_diagonal );
+}
+
+pf::simple_path<tripoint_abs_omt> overmapbuffer::get_travel_path(
+    const tripoint_abs_omt &src, const tripoint_abs_omt &dest, const overmap_path_params &params )
+{
+    if( src.is_invalid() || dest.is_invalid() ) {
+        return {};
+    }
+
     constexpr int radius = 4 * OMAPX; // radius of search in OMTs = 4 overmaps
-    const pf::simple_path<tripoint_abs_omt> &path = pf::find_overmap_path( src, dest, radius, estimate,
-            g->display_om_pathfinding_progress, std::nullopt, params.allow_diagonal );
-    return path;
+    return find_travel_path( src, dest, params, radius );
+}
+
+// How far off a cached path a source may be to be routed back onto it, in OMTs
+static constexpr int travel_path_rejoin_dist = 8;
+static constexpr size_t max_cached_travel_paths = 32;
+
+static bool same_path_params( const overmap_path_params &a, const overmap_path_params &b )
+{
+    return a.travel_cost_per_type == b.travel_cost_per_type && a.avoid_danger == b.avoid_danger &&
+           a.only_known_by_player == b.only_known_by_player && a.allow_diagonal == b.allow_diagonal;
+}
+
+// Links a path, given from dest back to its source, into a tree of paths to the same dest.
+// Stops at the first point already in the tree, as that one already leads to dest.
+static void add_travel_path( std::unordered_map<tripoint_abs_omt, tripoint_abs_omt> &next_step,
+                             const std::vector<tripoint_abs_omt> &points )
+{
+    for( size_t i = points.size(); i-- > 0; ) {
+        const tripoint_abs_omt &next = i == 0 ? points[i] : points[i - 1];
+        if( !next_step.emplace( points[i], next ).second ) {
+            break;
+        }
+    }
+}
+
+static std::vector<tripoint_abs_omt> travel_path_from(
+    const std::unordered_map<tripoint_abs_omt, tripoint_abs_omt> &next_step,
+    const tripoint_abs_omt &src )
+{
+    std::vector<tripoint_abs_omt> ret;
+    tripoint_abs_omt cur = src;
+    while( ret.size() <= next_step.size() ) {
+        ret.push_back( cur );
+        const tripoint_abs_omt &next = next_step.at( cur );
+        if( next == cur ) {
+            break;
+        }
+        cur = next;
+    }
+    std::reverse( ret.begin(), ret.end() );
+    return ret;
+}
+
+std::vector<tripoint_abs_omt> overmapbuffer::get_cached_travel_path( const tripoint_abs_omt &src,
+        const tripoint_abs_omt &dest, const overmap_path_params &params )
+{
+    if( params.only_known_by_player || params.avoid_danger ) {
+        // Depends on what the player has seen and marked, which invalidates nothing here
+        return get_travel_path( src, dest, params ).points;
+    }
+    if( src.is_invalid() || dest.is_invalid() ) {
+        return {};
+    }
+
+    ++travel_path_lookups;
+    auto entry = std::find_if( travel_paths.begin(), travel_paths.end(),
+    [&]( const cached_travel_path & cached ) {
+        return cached.dest == dest && same_path_params( cached.params, params );
+    } );
+    if( entry != travel_paths.end() ) {
+        entry->last_used = travel_path_lookups;
+        if( entry->next_step.count( src ) ) {
+            return travel_path_from( entry->next_step, src );
+        }
+        // Most likely somebody who left the path for a bit, so try to get back onto it at the
+        // closest point instead of searching all the way to dest.
+        std::optional<tripoint_abs_omt> rejoin;
+        int rejoin_dist = travel_path_rejoin_dist + 1;
+        for( const std::pair<const tripoint_abs_omt, tripoint_abs_omt> &step : entry->next_step ) {
+            const int dist = rl_dist( src, step.first );
+            if( dist < rejoin_dist || ( dist == rejoin_dist && rejoin && step.first < *rejoin ) ) {
+                rejoin = step.first;
+                rejoin_dist = dist;
+            }
+        }
+        if( rejoin ) {
+            const pf::simple_path<tripoint_abs_omt> detour = find_travel_path( src, *rejoin, params,
+                    2 * travel_path_rejoin_dist );
+            if( !detour.points.empty() ) {
+                add_travel_path( entry->next_step, detour.points );
+                return travel_path_from( entry->next_step, src );
+            }
+        }
+    }
+
+    const std::vector<tripoint_abs_omt> points = get_travel_path( src, dest, params ).points;
+    if( points.empty() ) {
+        return points;
+    }
+    if( entry == travel_paths.end() ) {
+        if( travel_paths.size() < max_cached_travel_paths ) {
+            entry = travel_paths.emplace( travel_paths.end() );
+        } else {
+            entry = std::min_element( travel_paths.begin(), travel_paths.end(),
+            []( const cached_travel_path & a, const cached_travel_path & b ) {
+                return a.last_used < b.last_used;
+            } );
+            entry->next_step.clear();
+        }
+        entry->dest = dest;
+        entry->params = params;
+        entry->last_used = travel_path_lookups;
+    }
+    add_travel_path( entry->next_step, points );
+    return travel_path_from( entry->next_step, src );
+}
+
+void overmapbuffer::terrain_changed()
+{
+    travel_paths.clear();
 }
 
 bool overmapbuffer::reveal_route( const tripoint_abs_omt &source, const tripoint_abs_omt &dest,
@@ -2103,51 +2243,36 @@ void overmapbuffer::spawn_monster( const tripoint_abs_sm &p, bool spawn_nonlocal
     tripoint_om_sm current_submap_loc;
     std::tie( omp, current_submap_loc ) = project_remain<coords::om>( p );
     overmap &om = get( omp );
-    std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> monster_bucket =
-        om.hordes.entity_group_at( current_submap_loc );
-    if( monster_bucket.empty() ) {
+    using queued_entity = std::pair<tripoint_abs_ms, horde_entity>;
+    std::vector<queued_entity> to_spawn = om.hordes.extract_chunk( current_submap_loc );
+    if( to_spawn.empty() ) {
         return;
     }
     map &here = get_map();
 
-    struct queued_node {
-        tripoint_abs_ms pos;
-        horde_map::node_type node;
-    };
-    std::vector<queued_node> to_spawn;
-    for( std::unordered_map<tripoint_abs_ms, horde_entity> *monster_tree : monster_bucket ) {
-        for( auto it = monster_tree->begin(); it != monster_tree->end(); ) {
-            auto cur = it++;
-            tripoint_abs_ms pos = cur->first;
-            to_spawn.push_back( queued_node{ pos, monster_tree->extract( cur ) } );
-        }
-    }
-    om.hordes.clear_chunk( current_submap_loc );
-
     // Deterministic order, preserving bucket sequence as tie-break.
     std::stable_sort( to_spawn.begin(), to_spawn.end(),
-    []( const queued_node & a, const queued_node & b ) {
-        return a.pos < b.pos;
+    []( const queued_entity & a, const queued_entity & b ) {
+        return a.first < b.first;
     } );
 
-    for( queued_node &entry : to_spawn ) {
-        const tripoint_bub_ms local = here.get_bub( entry.pos );
+    for( queued_entity &entry : to_spawn ) {
+        const tripoint_bub_ms local = here.get_bub( entry.first );
         if( !spawn_nonlocal ) {
             cata_assert( here.inbounds( local ) );
         }
         monster *placed = nullptr;
-        if( entry.node.mapped().monster_data ) {
-            placed = g->place_critter_around( make_shared_fast<monster>(
-                                                  *entry.node.mapped().monster_data ),
+        if( entry.second.monster_data ) {
+            placed = g->place_critter_around( make_shared_fast<monster>( *entry.second.monster_data ),
                                               local, 1, true );
             // TODO: make sure entity data such as destination is synched
         } else {
-            placed = g->place_critter_around( entry.node.mapped().type_id->id, local, 1 );
+            placed = g->place_critter_around( entry.second.type_id->id, local, 1 );
         }
         if( placed ) {
             placed->on_load();
         } else {
-            om.hordes.insert( std::move( entry.node ) );
+            om.hordes.insert( entry.first, std::move( entry.second ) );
         }
     }
 }
@@ -2175,7 +2300,7 @@ void overmapbuffer::despawn_monster( const monster &critter )
     }
 }
 
-horde_entity *overmapbuffer::entity_at( const tripoint_abs_ms &p )
+std::optional<horde_entity_ref> overmapbuffer::entity_at( const tripoint_abs_ms &p )
 {
     point_abs_om omp;
     tripoint_om_ms oms;
@@ -2184,7 +2309,7 @@ horde_entity *overmapbuffer::entity_at( const tripoint_abs_ms &p )
     return om.entity_at( oms );
 }
 
-std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> overmapbuffer::hordes_at(
+std::vector<horde_chunk *> overmapbuffer::hordes_at(
     const tripoint_abs_omt &p, int filter )
 {
     point_abs_om omp;
@@ -2194,7 +2319,8 @@ std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> overmapbuffer::h
     return om.hordes_at( omt, filter );
 }
 
-horde_entity &overmapbuffer::spawn_monster( const tripoint_abs_ms &p, mtype_id id )
+std::optional<horde_entity_ref> overmapbuffer::spawn_monster( const tripoint_abs_ms &p,
+        mtype_id id )
 {
     // Get the overmap coordinates and get the overmap, sm is now local to that overmap
     point_abs_om omp;
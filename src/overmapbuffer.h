@@ -4,6 +4,7 @@
 
 #include <array>
 #include <bitset>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -43,7 +44,6 @@ namespace om_direction
 {
 enum class type : int;
 }  // namespace om_direction
-struct horde_entity;
 struct map_data_summary;
 struct mapgen_arguments;
 struct mongroup;
@@ -434,6 +434,16 @@ class overmapbuffer
                      const std::function<bool( const oter_id & )> &filter );
         pf::simple_path<tripoint_abs_omt> get_travel_path(
             const tripoint_abs_omt &src, const tripoint_abs_omt &dest, const overmap_path_params &params );
+        /**
+         * Points of get_travel_path(), reusing paths found before where possible.
+         * A source on a known path to dest gets the rest of that path, and a source a few
+         * OMTs off it is routed back onto it by a short search.  Only params that do not
+         * depend on the player's knowledge are cached, others always search anew.
+         */
+        std::vector<tripoint_abs_omt> get_cached_travel_path( const tripoint_abs_omt &src,
+                const tripoint_abs_omt &dest, const overmap_path_params &params );
+        /** Drops cached travel paths, must be called whenever overmap terrain changes. */
+        void terrain_changed();
         bool reveal_route( const tripoint_abs_omt &source, const tripoint_abs_omt &dest,
                            int radius = 0, bool road_only = false );
         /**
@@ -564,15 +574,15 @@ class overmapbuffer
         /**
          * Spawn a specified monster type at a specified location on an overmap.
          */
-        horde_entity &spawn_monster( const tripoint_abs_ms &p, mtype_id id );
+        std::optional<horde_entity_ref> spawn_monster( const tripoint_abs_ms &p, mtype_id id );
         /**
          * Despawn the monster back onto the overmap. The monsters position
          * (monster::pos()) is interpreted as relative to the main map.
          */
         void despawn_monster( const monster &critter );
         void spawn_mongroup( const tripoint_abs_sm &p, const mongroup_id &type, int count );
-        horde_entity *entity_at( const tripoint_abs_ms &p );
-        std::vector<std::unordered_map<tripoint_abs_ms, horde_entity>*> hordes_at(
+        std::optional<horde_entity_ref> entity_at( const tripoint_abs_ms &p );
+        std::vector<horde_chunk *> hordes_at(
             const tripoint_abs_omt &p, int filter = horde_map_flavors::active | horde_map_flavors::idle |
                     horde_map_flavors::dormant | horde_map_flavors::immobile );
         /**
@@ -664,6 +674,17 @@ class overmapbuffer
         // Cached result of previous call to overmapbuffer::get_existing
         overmap mutable *last_requested_overmap;
 
+        struct cached_travel_path {
+            tripoint_abs_omt dest;
+            overmap_path_params params;
+            // Known paths to dest merged into a tree: every point maps to the next one on its
+            // way to dest, and dest maps to itself.
+            std::unordered_map<tripoint_abs_omt, tripoint_abs_omt> next_step;
+            uint64_t last_used = 0;
+        };
+        std::vector<cached_travel_path> travel_paths;
+        uint64_t travel_path_lookups = 0;
+
         /**
          * Get a list of notes in the (loaded) overmaps.
          * @param z only this specific z-level is search for notes.
@@ -2,7 +2,8 @@
 
 #include <algorithm>
 #include <array>
-#include <bitset>
+#include <climits>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <memory>
@@ -15,6 +16,7 @@
 #include <vector>
 
 #include "avatar.h"
+#include "calendar.h"
 #include "cata_utility.h"
 #include "character.h"
 #include "coordinates.h"
@@ -23,6 +25,7 @@
 #include "debug.h"
 #include "enums.h"
 #include "game.h"
+#include "hash_utils.h"
 #include "line.h"
 #include "map.h"
 #include "map_scale_constants.h"
@@ -44,26 +47,88 @@ static constexpr int flat_index( const point_bub_ms &p )
     return ( p.x() * MAPSIZE_Y ) + p.y();
 }
 
+static constexpr point_bub_ms unflatten_index( const int index )
+{
+    return point_bub_ms( index / MAPSIZE_Y, index % MAPSIZE_Y );
+}
+
+static_assert( MAPSIZE_X * MAPSIZE_Y <= 65536, "path_node::parent must fit a flat index" );
+
+// Search state of a single tile.  Only meaningful while generation matches the search
+// reading it, everything else counts as neither open nor closed.  This saves clearing the
+// whole layer before every search, which used to dominate the cost of short routes.
+struct path_node {
+    int gscore = 0;
+    uint32_t generation = 0;
+    // Flat index of the parent tile, on parent_z
+    uint16_t parent = 0;
+    int8_t parent_z = 0;
+    bool closed = false;
+};
+
 // Flattened 2D array representing a single z-level worth of pathfinding data
 struct path_data_layer {
-    // Closed/open is accessed way more often than all other values here
-    std::bitset< MAPSIZE_X *MAPSIZE_Y > closed;
-    std::bitset< MAPSIZE_X *MAPSIZE_Y > open;
-    std::array< int, MAPSIZE_X *MAPSIZE_Y > score;
-    std::array< int, MAPSIZE_X *MAPSIZE_Y > gscore;
-    std::array< tripoint_bub_ms, MAPSIZE_X *MAPSIZE_Y > parent;
+    std::array< path_node, MAPSIZE_X *MAPSIZE_Y > nodes;
+};
 
-    void reset() {
-        closed.reset();
-        open.reset();
-    }
+// Open list bucketed by score.  Scores are small non-negative integers, so finding the
+// lowest one is a short scan instead of a heap operation.  Points with equal score come
+// out last in, first out.
+class path_open_list
+{
+    public:
+        bool empty() const {
+            return size == 0;
+        }
+
+        void push( const int score, const tripoint_bub_ms &p ) {
+            const size_t bucket = static_cast<size_t>( score );
+            if( bucket >= buckets.size() ) {
+                buckets.resize( bucket + 1 );
+            }
+            buckets[bucket].push_back( p );
+            lowest = std::min( lowest, bucket );
+            highest = std::max( highest, bucket );
+            ++size;
+        }
+
+        tripoint_bub_ms pop() {
+            while( buckets[lowest].empty() ) {
+                ++lowest;
+            }
+            const tripoint_bub_ms p = buckets[lowest].back();
+            buckets[lowest].pop_back();
+            --size;
+            return p;
+        }
+
+        void clear() {
+            if( size != 0 ) {
+                for( size_t i = lowest; i <= highest; ++i ) {
+                    buckets[i].clear();
+                }
+            }
+            lowest = buckets.size();
+            highest = 0;
+            size = 0;
+        }
+
+    private:
+        std::vector<std::vector<tripoint_bub_ms>> buckets;
+        size_t lowest = 0;
+        size_t highest = 0;
+        size_t size = 0;
 };
 
 struct pathfinder {
-    using queue_type =
-        std::priority_queue< std::pair<int, tripoint_bub_ms>, std::vector< std::pair<int, tripoint_bub_ms> >, pair_greater_cmp_first >;
-    queue_type open;
+    path_open_list open;
     std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
+    // Stamp of the current search, see path_node
+    uint32_t generation = 0;
+    // Parent of each node of map::route_corridor(), only meaningful where the stamp matches
+    // generation, like path_node.
+    std::vector<int> corridor_parents;
+    std::vector<uint32_t> corridor_stamps;
 
     path_data_layer &get_layer( const int z ) {
         std::unique_ptr< path_data_layer > &ptr = path_data[z + OVERMAP_DEPTH];
@@ -74,14 +139,20 @@ struct pathfinder {
         return *ptr;
     }
 
-    void reset( int minz, int maxz ) {
-        for( int i = minz; i <= maxz; ++i ) {
-            std::unique_ptr< path_data_layer > &ptr = path_data[i + OVERMAP_DEPTH];
-            if( ptr != nullptr ) {
-                path_data[i + OVERMAP_DEPTH]->reset();
+    void reset() {
+        if( ++generation == 0 ) {
+            // Wrapped around, old stamps could now look current
+            for( std::unique_ptr< path_data_layer > &ptr : path_data ) {
+                if( ptr != nullptr ) {
+                    for( path_node &node : ptr->nodes ) {
+                        node.generation = 0;
+                    }
+                }
             }
+            std::fill( corridor_stamps.begin(), corridor_stamps.end(), 0 );
+            generation = 1;
         }
-        open = queue_type();
+        open.clear();
     }
 
     bool empty() const {
@@ -89,43 +160,86 @@ struct pathfinder {
     }
 
     tripoint_bub_ms get_next() {
-        const auto pt = open.top();
-        open.pop();
-        return pt.second;
+        return open.pop();
+    }
+
+    bool is_closed( const path_node &node ) const {
+        return node.generation == generation && node.closed;
+    }
+
+    void close( path_node &node ) {
+        if( node.generation != generation ) {
+            node.generation = generation;
+            node.gscore = 0;
+        }
+        node.closed = true;
     }
 
     void add_point( const int gscore, const int score, const tripoint_bub_ms &from,
                     const tripoint_bub_ms &to ) {
-        path_data_layer &layer = get_layer( to.z() );
-        const int index = flat_index( to.xy() );
-        if( layer.closed[index] ) {
-            return;
-        }
-        if( layer.open[index] && gscore >= layer.gscore[index] ) {
+        path_node &node = get_layer( to.z() ).nodes[flat_index( to.xy() )];
+        if( node.generation == generation && ( node.closed || gscore >= node.gscore ) ) {
             return;
         }
 
-        layer.open[index] = true;
-        layer.gscore[index] = gscore;
-        layer.parent[index] = from;
-        layer.score [index] = score;
-        open.emplace( score, to );
+        node.generation = generation;
+        node.closed = false;
+        node.gscore = gscore;
+        node.parent = static_cast<uint16_t>( flat_index( from.xy() ) );
+        node.parent_z = static_cast<int8_t>( from.z() );
+        open.push( score, to );
     }
 
-    void close_point( const tripoint_bub_ms &p ) {
-        path_data_layer &layer = get_layer( p.z() );
-        const int index = flat_index( p.xy() );
-        layer.closed[index] = true;
+    tripoint_bub_ms parent_of( const tripoint_bub_ms &p ) {
+        const path_node &node = get_layer( p.z() ).nodes[flat_index( p.xy() )];
+        return tripoint_bub_ms( unflatten_index( node.parent ), node.parent_z );
+    }
+
+    void reserve_corridor( const size_t nodes ) {
+        if( corridor_parents.size() < nodes ) {
+            corridor_parents.resize( nodes );
+            corridor_stamps.resize( nodes, 0 );
+        }
     }
 
-    void unclose_point( const tripoint_bub_ms &p ) {
-        path_data_layer &layer = get_layer( p.z() );
-        const int index = flat_index( p.xy() );
-        layer.closed[index] = false;
+    // -1 if the node wasn't reached.
+    int corridor_parent( const int node ) const {
+        return corridor_stamps[node] == generation ? corridor_parents[node] : -1;
+    }
+
+    void set_corridor_parent( const int node, const int parent ) {
+        corridor_stamps[node] = generation;
+        corridor_parents[node] = parent;
     }
 };
 
-static pathfinder pf;
+// Pathfinder state is large, so it is kept around for reuse. A search started while another
+// is running, from an avoid callback for example, gets another one.
+static std::vector<std::unique_ptr<pathfinder>> pathfinder_pool;
+static size_t pathfinders_in_use = 0;
+
+class pathfinder_lease
+{
+    public:
+        pathfinder_lease() {
+            if( pathfinders_in_use == pathfinder_pool.size() ) {
+                pathfinder_pool.push_back( std::make_unique<pathfinder>() );
+            }
+            pf = pathfinder_pool[pathfinders_in_use++].get();
+        }
+        ~pathfinder_lease() {
+            --pathfinders_in_use;
+        }
+        pathfinder_lease( const pathfinder_lease & ) = delete;
+        pathfinder_lease &operator=( const pathfinder_lease & ) = delete;
+
+        pathfinder &get() const {
+            return *pf;
+        }
+
+    private:
+        pathfinder *pf;
+};
 
 // Modifies `t` to point to a tile with `flag` in a 1-submap radius of `t`'s original value,
 // searching nearest points first (starting with `t` itself).
@@ -395,6 +509,305 @@ int map::extra_cost( const tripoint_bub_ms &cur, const tripoint_bub_ms &p,
     return pass_cost + avoid_cost;
 }
 
+// Below this many requests for the same route on one turn, separate searches are cheaper
+// than a flow field covering the whole z-level.
+static constexpr int flow_field_min_requests = 3;
+static constexpr int flow_field_max_count = 8;
+static constexpr int flow_field_unreachable = INT_MAX;
+
+bool flow_field_cache::key::operator==( const key &rhs ) const
+{
+    const pathfinding_settings &a = settings;
+    const pathfinding_settings &b = rhs.settings;
+    // max_dist only decides whether to search at all, and flow fields don't change z-levels.
+    return target == rhs.target && a.bash_strength == b.bash_strength &&
+           a.max_length == b.max_length && a.climb_cost == b.climb_cost &&
+           a.allow_open_doors == b.allow_open_doors && a.allow_unlock_doors == b.allow_unlock_doors &&
+           a.avoid_traps == b.avoid_traps && a.avoid_rough_terrain == b.avoid_rough_terrain &&
+           a.avoid_sharp == b.avoid_sharp && a.avoid_dangerous_fields == b.avoid_dangerous_fields &&
+           a.size == b.size;
+}
+
+std::size_t flow_field_cache::key_hash::operator()( const key &k ) const
+{
+    const pathfinding_settings &s = k.settings;
+    std::size_t seed = std::hash<tripoint_bub_ms>()( k.target );
+    for( const std::pair<const damage_type_id, int> &bash : s.bash_strength ) {
+        cata::hash_combine( seed, bash.second );
+    }
+    cata::hash_combine( seed, s.max_length );
+    cata::hash_combine( seed, s.climb_cost );
+    const int flags = s.allow_open_doors | ( s.allow_unlock_doors << 1 ) | ( s.avoid_traps << 2 ) |
+                      ( s.avoid_rough_terrain << 3 ) | ( s.avoid_sharp << 4 ) |
+                      ( s.avoid_dangerous_fields << 5 );
+    cata::hash_combine( seed, flags );
+    cata::hash_combine( seed, s.size ? static_cast<int>( *s.size ) : -1 );
+    return seed;
+}
+
+const flow_field *map::shared_flow_field( const tripoint_bub_ms &t,
+        const pathfinding_settings &settings ) const
+{
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( t.z() );
+    if( !flow_fields ) {
+        flow_fields = std::make_unique<flow_field_cache>();
+    }
+    flow_field_cache &cache = *flow_fields;
+    if( cache.turn != calendar::turn ) {
+        cache.turn = calendar::turn;
+        cache.requests.clear();
+        cache.built.clear();
+    }
+
+    const auto inserted = cache.requests.emplace( flow_field_cache::key{ t, settings },
+                          flow_field_cache::request() );
+    flow_field_cache::request &req = inserted.first->second;
+    if( inserted.second ) {
+        req.cache_revision = pf_cache.revision;
+        req.count = 1;
+        return nullptr;
+    }
+    if( req.field ) {
+        if( req.field->cache_revision == pf_cache.revision ) {
+            return req.field.get();
+        }
+        req.field.reset();
+        cache.built.erase( std::find( cache.built.begin(), cache.built.end(), &req ) );
+    }
+    if( req.cache_revision != pf_cache.revision ) {
+        // The map changed since. Don't build a field right away, the same thing may well
+        // happen again before the next creature asks.
+        req.cache_revision = pf_cache.revision;
+        req.count = 1;
+        return nullptr;
+    }
+    if( ++req.count < flow_field_min_requests ) {
+        return nullptr;
+    }
+
+    if( cache.built.size() >= flow_field_max_count ) {
+        cache.built.front()->field.reset();
+        cache.built.erase( cache.built.begin() );
+    }
+    req.field = std::make_unique<flow_field>();
+    req.field->target = t;
+    req.field->settings = settings;
+    build_flow_field( *req.field );
+    cache.built.push_back( &req );
+    return req.field.get();
+}
+
+// Dijkstra outwards from the target, so every step is costed the way map::route() would cost
+// it in the opposite direction.
+void map::build_flow_field( flow_field &field ) const
+{
+    const tripoint_bub_ms &t = field.target;
+    const pathfinding_settings &settings = field.settings;
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( t.z() );
+    field.cache_revision = pf_cache.revision;
+    field.cost.fill( flow_field_unreachable );
+
+    using queue_entry = std::pair<int, point_bub_ms>;
+    std::priority_queue<queue_entry, std::vector<queue_entry>, pair_greater_cmp_first> open;
+    field.cost[t.xy()] = 0;
+    open.emplace( 0, t.xy() );
+    while( !open.empty() ) {
+        const queue_entry top = open.top();
+        open.pop();
+        const point_bub_ms &to = top.second;
+        if( top.first > field.cost[to] ) {
+            continue;
+        }
+        const PathfindingFlags to_special = pf_cache.special[to];
+        // map::route() climbs down rather than walking over these.
+        if( settings.avoid_traps && to != t.xy() && ( ( to_special & PathfindingFlag::Air ) ||
+                ( ( to_special & PathfindingFlag::DangerousTrap ) &&
+                  has_flag( ter_furn_flag::TFLAG_NO_FLOOR, tripoint_bub_ms( to, t.z() ) ) ) ) ) {
+            continue;
+        }
+        for( const tripoint &offset : eight_horizontal_neighbors ) {
+            const point_bub_ms from = to - offset.xy();
+            if( !inbounds( tripoint_bub_ms( from, t.z() ) ) ) {
+                continue;
+            }
+            const int step = extra_cost( tripoint_bub_ms( from, t.z() ), tripoint_bub_ms( to, t.z() ),
+                                         settings, to_special );
+            if( step < 0 ) {
+                continue;
+            }
+            // Penalize for diagonals, as map::route() does.
+            const int new_cost = top.first + step + ( offset.x != 0 && offset.y != 0 ? 1 : 0 );
+            if( new_cost > settings.max_length || new_cost >= field.cost[from] ) {
+                continue;
+            }
+            field.cost[from] = new_cost;
+            field.next[from] = to;
+            open.emplace( new_cost, from );
+        }
+    }
+}
+
+// Routes shorter than this are searched for directly.
+static constexpr int corridor_route_min_dist = 3 * SEEX;
+// Corridors that pass through more submaps than this many times the straight line are left
+// to the full search for creatures that can open, climb or bash their way through.
+static constexpr int corridor_max_detour = 2;
+
+// Labels the areas of open ground in each dirty submap with a flood fill that stays within it.
+void map::update_path_areas( int zlev ) const
+{
+    // Brings special up to date first.
+    get_pathfinding_cache_ref( zlev );
+    pathfinding_cache &cache = get_pathfinding_cache( zlev );
+    // Anything that can be walked over without climbing, bashing or opening something.
+    constexpr PathfindingFlags closed = PathfindingFlag::Obstacle | PathfindingFlag::Air;
+    const int size = getmapsize();
+    std::vector<point_bub_ms> stack;
+    for( int smx = 0; smx < size; ++smx ) {
+        for( int smy = 0; smy < size; ++smy ) {
+            const point_bub_sm sm( smx, smy );
+            if( !cache.areas_dirty[sm] ) {
+                continue;
+            }
+            cache.areas_dirty[sm] = false;
+            const point_bub_ms origin = project_to<coords::ms>( sm );
+            for( int x = 0; x < SEEX; ++x ) {
+                for( int y = 0; y < SEEY; ++y ) {
+                    cache.areas[origin + point( x, y )] = 0;
+                }
+            }
+            uint8_t next_area = 0;
+            for( int x = 0; x < SEEX; ++x ) {
+                for( int y = 0; y < SEEY; ++y ) {
+                    const point_bub_ms start = origin + point( x, y );
+                    if( cache.areas[start] != 0 || ( cache.special[start] & closed ) ) {
+                        continue;
+                    }
+                    ++next_area;
+                    cache.areas[start] = next_area;
+                    stack.push_back( start );
+                    while( !stack.empty() ) {
+                        const point_bub_ms cur = stack.back();
+                        stack.pop_back();
+                        for( const tripoint &offset : eight_horizontal_neighbors ) {
+                            const point_bub_ms p = cur + offset.xy();
+                            if( project_to<coords::sm>( p ) != sm || cache.areas[p] != 0 ||
+                                ( cache.special[p] & closed ) ) {
+                                continue;
+                            }
+                            cache.areas[p] = next_area;
+                            stack.push_back( p );
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Breadth first search over the areas of open ground, moving between the areas of neighboring
+// submaps that have tiles next to each other.
+std::optional<cata::mdarray<bool, point_bub_sm>> map::route_corridor( const tripoint_bub_ms &f,
+        const tripoint_bub_ms &t, const tripoint_bub_ms &min, const tripoint_bub_ms &max,
+        const pathfinding_settings &settings ) const
+{
+    update_path_areas( f.z() );
+    const pathfinding_cache &cache = get_pathfinding_cache_ref( f.z() );
+    const uint8_t start_area = cache.areas[f.xy()];
+    const uint8_t goal_area = cache.areas[t.xy()];
+    if( start_area == 0 || goal_area == 0 ) {
+        return std::nullopt;
+    }
+    const point_bub_sm min_sm = project_to<coords::sm>( min.xy() );
+    const point_bub_sm max_sm = project_to<coords::sm>( max.xy() );
+    const int size = getmapsize();
+    // A node is an area of a submap.
+    const auto node_index = [size]( const point_bub_sm & sm, uint8_t area ) {
+        return ( sm.x() * size + sm.y() ) * 256 + area;
+    };
+    const int goal = node_index( project_to<coords::sm>( t.xy() ), goal_area );
+    const pathfinder_lease lease;
+    pathfinder &pf = lease.get();
+    pf.reset();
+    pf.reserve_corridor( static_cast<size_t>( size ) * size * 256 );
+    std::queue<std::pair<point_bub_sm, uint8_t>> open;
+    const int start = node_index( project_to<coords::sm>( f.xy() ), start_area );
+    pf.set_corridor_parent( start, start );
+    open.emplace( project_to<coords::sm>( f.xy() ), start_area );
+    while( !open.empty() && pf.corridor_parent( goal ) < 0 ) {
+        const point_bub_sm sm = open.front().first;
+        const uint8_t area = open.front().second;
+        open.pop();
+        const int index = node_index( sm, area );
+        const point_bub_ms origin = project_to<coords::ms>( sm );
+        // Only the edges of the submap lead out of it.
+        for( int x = 0; x < SEEX; ++x ) {
+            for( int y = 0; y < SEEY; ++y ) {
+                if( x != 0 && x != SEEX - 1 && y != 0 && y != SEEY - 1 ) {
+                    continue;
+                }
+                const point_bub_ms p = origin + point( x, y );
+                if( cache.areas[p] != area ) {
+                    continue;
+                }
+                for( const tripoint &offset : eight_horizontal_neighbors ) {
+                    const point_bub_ms next = p + offset.xy();
+                    const point_bub_sm next_sm = project_to<coords::sm>( next );
+                    if( next_sm == sm || !inbounds( tripoint_bub_ms( next, f.z() ) ) ||
+                        next_sm.x() < min_sm.x() || next_sm.x() > max_sm.x() ||
+                        next_sm.y() < min_sm.y() || next_sm.y() > max_sm.y() ) {
+                        continue;
+                    }
+                    const uint8_t next_area = cache.areas[next];
+                    if( next_area == 0 ) {
+                        continue;
+                    }
+                    const int next_index = node_index( next_sm, next_area );
+                    if( pf.corridor_parent( next_index ) < 0 ) {
+                        pf.set_corridor_parent( next_index, index );
+                        open.emplace( next_sm, next_area );
+                    }
+                }
+            }
+        }
+    }
+    if( pf.corridor_parent( goal ) < 0 ) {
+        return std::nullopt;
+    }
+    // Only open ground was looked at, so a long way around may well be shorter through a door
+    // or a wall for those who can get through.
+    if( !settings.bash_strength.empty() || settings.allow_open_doors || settings.climb_cost > 0 ) {
+        const point_rel_sm direct = project_to<coords::sm>( t.xy() ) - project_to<coords::sm>( f.xy() );
+        const int direct_hops = std::max( std::abs( direct.x() ), std::abs( direct.y() ) );
+        int hops = 0;
+        for( int node = goal; node != start; node = pf.corridor_parent( node ) ) {
+            ++hops;
+        }
+        if( hops > corridor_max_detour * direct_hops + 1 ) {
+            return std::nullopt;
+        }
+    }
+
+    cata::mdarray<bool, point_bub_sm> corridor;
+    corridor.fill( false );
+    for( int node = goal; ; node = pf.corridor_parent( node ) ) {
+        const int sm_index = node / 256;
+        const point_bub_sm sm( sm_index / size, sm_index % size );
+        for( int dx = -1; dx <= 1; ++dx ) {
+            for( int dy = -1; dy <= 1; ++dy ) {
+                const point_bub_sm around = sm + point( dx, dy );
+                if( around.x() >= 0 && around.x() < size && around.y() >= 0 && around.y() < size ) {
+                    corridor[around] = true;
+                }
+            }
+        }
+        if( node == start ) {
+            break;
+        }
+    }
+    return corridor;
+}
+
 std::vector<tripoint_bub_ms> map::route( const Creature &who,
         const pathfinding_target &target ) const
 {
@@ -450,8 +863,6 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
         return ret;
     }
 
-    const int max_length = settings.max_length;
-
     const int pad = 16;  // Should be much bigger - low value makes pathfinders dumb!
     tripoint_bub_ms min( std::min( f.x(), t.x() ) - pad, std::min( f.y(), t.y() ) - pad,
                          std::min( f.z(), t.z() ) );
@@ -460,7 +871,56 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
     clip_to_bounds( min.x(), min.y(), min.z() );
     clip_to_bounds( max.x(), max.y(), max.z() );
 
-    pf.reset( min.z(), max.z() );
+    if( target.r == 0 && f.z() == t.z() ) {
+        if( const flow_field *field = shared_flow_field( t, settings ) ) {
+            // Walking over a hole is the only way down the flow field doesn't know about.
+            if( field->cost[f.xy()] == flow_field_unreachable && !settings.avoid_traps ) {
+                return ret;
+            }
+            // The field ignores avoid, and isn't limited to the area searched below. Only use
+            // it if its route is one that the search could have returned.
+            bool usable = field->cost[f.xy()] != flow_field_unreachable;
+            for( tripoint_bub_ms cur = f; usable && cur != t; ) {
+                cur = tripoint_bub_ms( field->next[cur.xy()], t.z() );
+                usable = cur.x() >= min.x() && cur.x() < max.x() && cur.y() >= min.y() &&
+                         cur.y() < max.y() && ( cur == t || !avoid( cur ) );
+                ret.push_back( cur );
+            }
+            if( usable ) {
+                return ret;
+            }
+            ret.clear();
+        }
+    }
+
+    // Long routes are planned over open ground a submap at a time first, so that the search
+    // doesn't get lost in the dead ends of everything that isn't on the way.
+    if( f.z() == t.z() && rl_dist( f, t ) >= corridor_route_min_dist ) {
+        const std::optional<cata::mdarray<bool, point_bub_sm>> corridor = route_corridor( f, t, min,
+                max, settings );
+        if( corridor ) {
+            ret = route_search( f, target, settings, avoid, min, max, &*corridor );
+            if( !ret.empty() ) {
+                return ret;
+            }
+        }
+    }
+    return route_search( f, target, settings, avoid, min, max, nullptr );
+}
+
+std::vector<tripoint_bub_ms> map::route_search( const tripoint_bub_ms &f,
+        const pathfinding_target &target, const pathfinding_settings &settings,
+        const std::function<bool( const tripoint_bub_ms & )> &avoid,
+        const tripoint_bub_ms &min, const tripoint_bub_ms &max,
+        const cata::mdarray<bool, point_bub_sm> *corridor ) const
+{
+    std::vector<tripoint_bub_ms> ret;
+    const tripoint_bub_ms &t = target.center;
+    const int max_length = settings.max_length;
+
+    const pathfinder_lease lease;
+    pathfinder &pf = lease.get();
+    pf.reset();
 
     pf.add_point( 0, 0, f, f );
 
@@ -472,11 +932,11 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
 
         const int parent_index = flat_index( cur.xy() );
         path_data_layer &layer = pf.get_layer( cur.z() );
-        if( layer.closed[parent_index] ) {
+        if( pf.is_closed( layer.nodes[parent_index] ) ) {
             continue;
         }
 
-        if( layer.gscore[parent_index] > max_length ) {
+        if( layer.nodes[parent_index].gscore > max_length ) {
             // Shortest path would be too long, return empty vector
             return std::vector<tripoint_bub_ms>();
         }
@@ -487,7 +947,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
             break;
         }
 
-        layer.closed[parent_index] = true;
+        pf.close( layer.nodes[parent_index] );
 
         const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( cur.z() );
         const PathfindingFlags cur_special = pf_cache.special[cur.x()][cur.y()];
@@ -505,24 +965,27 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
             if( p.x() < min.x() || p.x() >= max.x() || p.y() < min.y() || p.y() >= max.y() ) {
                 continue;
             }
+            if( corridor != nullptr && !( *corridor )[project_to<coords::sm>( p.xy() )] ) {
+                continue;
+            }
 
             if( !target.contains( p ) && avoid( p ) ) {
-                layer.closed[index] = true;
+                pf.close( layer.nodes[index] );
                 continue;
             }
 
-            if( layer.closed[index] ) {
+            if( pf.is_closed( layer.nodes[index] ) ) {
                 continue;
             }
 
             // Penalize for diagonals or the path will look "unnatural"
-            int newg = layer.gscore[parent_index] + ( ( cur.x() != p.x() && cur.y() != p.y() ) ? 1 : 0 );
+            int newg = layer.nodes[parent_index].gscore + ( ( cur.x() != p.x() && cur.y() != p.y() ) ? 1 : 0 );
 
             const PathfindingFlags p_special = pf_cache.special[p.x()][p.y()];
             const int cost = extra_cost( cur, p, settings, p_special );
             if( cost < 0 ) {
                 if( cost == PF_IMPASSABLE ) {
-                    layer.closed[index] = true;
+                    pf.close( layer.nodes[index] );
                 }
                 continue;
             }
@@ -544,13 +1007,13 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
                             // From cur, not p, because we won't be walking on air.
                             // Use outer layer (cur.z()) for gscore -- the destination
                             // layer may contain stale data at parent_index.
-                            int new_g = layer.gscore[parent_index] + 10;
+                            int new_g = layer.nodes[parent_index].gscore + 10;
                             pf.add_point( new_g, new_g + 2 * rl_dist( below, t ),
                                           cur, below );
                         }
 
                         // Close p on the current z-level -- we won't walk on air
-                        layer.closed[index] = true;
+                        pf.close( layer.nodes[index] );
                         continue;
                     }
                 }
@@ -561,12 +1024,12 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
                 tripoint_bub_ms below( p + tripoint::below );
                 if( valid_move( p, below, false, true ) ) {
                     if( !has_flag( ter_furn_flag::TFLAG_NO_FLOOR, below ) ) {
-                        int new_g = layer.gscore[parent_index] + 10;
+                        int new_g = layer.nodes[parent_index].gscore + 10;
                         pf.add_point( new_g, new_g + 2 * rl_dist( below, t ),
                                       cur, below );
                     }
                 }
-                layer.closed[index] = true;
+                pf.close( layer.nodes[index] );
                 continue;
             }
 
@@ -597,7 +1060,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
                 }
                 // Use outer layer (cur.z()) for gscore -- the destination
                 // layer may contain stale data at parent_index.
-                int new_g = layer.gscore[parent_index] + 2;
+                int new_g = layer.nodes[parent_index].gscore + 2;
                 pf.add_point( new_g, new_g + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
@@ -614,7 +1077,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
                 if( !inbounds( dest ) ) {
                     continue;
                 }
-                int new_g = layer.gscore[parent_index] + 2;
+                int new_g = layer.nodes[parent_index].gscore + 2;
                 pf.add_point( new_g, new_g + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
@@ -626,7 +1089,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
                 if( !inbounds( above ) ) {
                     continue;
                 }
-                int new_g = layer.gscore[parent_index] + 4;
+                int new_g = layer.nodes[parent_index].gscore + 4;
                 pf.add_point( new_g, new_g + 2 * rl_dist( above, t ),
                               cur, above );
             }
@@ -638,7 +1101,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
                 if( !inbounds( above ) ) {
                     continue;
                 }
-                int new_g = layer.gscore[parent_index] + 4;
+                int new_g = layer.nodes[parent_index].gscore + 4;
                 pf.add_point( new_g, new_g + 2 * rl_dist( above, t ),
                               cur, above );
             }
@@ -650,7 +1113,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
                 if( !inbounds( below ) ) {
                     continue;
                 }
-                int new_g = layer.gscore[parent_index] + 4;
+                int new_g = layer.nodes[parent_index].gscore + 4;
                 pf.add_point( new_g, new_g + 2 * rl_dist( below, t ),
                               cur, below );
             }
@@ -663,9 +1126,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
         tripoint_bub_ms cur = found_target;
         // Just to limit max distance, in case something weird happens
         for( int fdist = max_length; fdist != 0; fdist-- ) {
-            const int cur_index = flat_index( cur.xy() );
-            const path_data_layer &layer = pf.get_layer( cur.z() );
-            const tripoint_bub_ms &par = layer.parent[cur_index];
+            const tripoint_bub_ms par = pf.parent_of( cur );
             if( cur == f ) {
                 break;
             }
@@ -5,10 +5,13 @@
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
 #include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "calendar.h"
 #include "coordinates.h"
 #include "mdarray.h"
 #include "point.h"
@@ -136,8 +139,17 @@ struct pathfinding_cache {
 
     bool dirty = false;
     std::unordered_set<point_bub_ms> dirty_points;
+    // Incremented every time special is updated, so that anything derived from it can tell
+    // it is out of date.
+    int revision = 0;
 
     cata::mdarray<PathfindingFlags, point_bub_ms> special;
+
+    // Within each submap, the tiles that connect to each other over open ground share a
+    // number, 0 for tiles that aren't open. Used to plan long routes a submap at a time,
+    // updated lazily for the submaps marked in areas_dirty.
+    cata::mdarray<uint8_t, point_bub_ms> areas;
+    cata::mdarray<bool, point_bub_sm> areas_dirty;
 };
 
 struct pathfinding_settings {
@@ -173,6 +185,43 @@ struct pathfinding_settings {
     pathfinding_settings &operator=( const pathfinding_settings & ) = default;
 };
 
+// The cost of the cheapest route to target from every tile on its z-level, for sharing between
+// the creatures heading for the same point on the same turn. See map::route().
+struct flow_field {
+    tripoint_bub_ms target;
+    pathfinding_settings settings;
+    // pathfinding_cache::revision of the z-level when the field was built.
+    int cache_revision = 0;
+    // INT_MAX where target can't be reached within settings.max_length.
+    cata::mdarray<int, point_bub_ms> cost;
+    // The step to take from each tile.
+    cata::mdarray<point_bub_ms, point_bub_ms> next;
+};
+
+struct flow_field_cache {
+    // Routes to the same target with settings that cost every step the same way share a key.
+    struct key {
+        tripoint_bub_ms target;
+        pathfinding_settings settings;
+        bool operator==( const key &rhs ) const;
+    };
+    struct key_hash {
+        std::size_t operator()( const key &k ) const;
+    };
+    struct request {
+        // Requests since the pathfinding_cache::revision of the z-level was this.
+        int cache_revision = 0;
+        int count = 0;
+        // Null until enough requests were made.
+        std::unique_ptr<flow_field> field;
+    };
+    // Requests and fields are only kept for one turn.
+    time_point turn = calendar::before_time_starts;
+    std::unordered_map<key, request, key_hash> requests;
+    // The requests that have a field, oldest first.
+    std::vector<request *> built;
+};
+
 struct pathfinding_target {
     const tripoint_bub_ms center;
     const int r;
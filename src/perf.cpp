@@ -1,13 +1,417 @@
 #include "perf.h"
 
-cata_timer::timers_map &cata_timer::top_level_timer_map()
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+
+#include "cata_assert.h"
+#include "debug.h"
+#include "enum_conversions.h"
+#include "json.h"
+
+namespace cata_perf
+{
+
+namespace
+{
+
+// Reserved id of the invisible root of every thread's call tree
+constexpr scope_id root_scope = 0;
+
+struct merged_node {
+    uint64_t ticks = 0;
+    uint64_t count = 0;
+    std::map<scope_id, merged_node> children;
+};
+
+struct timer_registry {
+    std::mutex mutex;
+    std::vector<std::string> names = { "" };
+    std::map<std::string, scope_id, std::less<>> ids;
+    std::vector<thread_timers *> threads;
+    // Timings of threads that have exited
+    merged_node retired;
+    // Timings at the last reset_stats(), reports only show what was recorded since.
+    merged_node baseline;
+    const std::chrono::steady_clock::time_point calibration_start = std::chrono::steady_clock::now();
+    const uint64_t calibration_start_ticks = ticks();
+};
+
+timer_registry &get_registry()
+{
+    static timer_registry registry;
+    return registry;
+}
+
+void merge( merged_node &into, const timer_node &from )
+{
+    into.ticks += from.ticks.load( std::memory_order_relaxed );
+    into.count += from.count.load( std::memory_order_relaxed );
+    for( const std::pair<scope_id, timer_node *> &child : from.children ) {
+        merge( into.children[child.first], *child.second );
+    }
+}
+
+void subtract( merged_node &from, const merged_node &base )
+{
+    from.ticks -= std::min( from.ticks, base.ticks );
+    from.count -= std::min( from.count, base.count );
+    for( const auto &[id, child] : base.children ) {
+        const auto it = from.children.find( id );
+        if( it != from.children.end() ) {
+            subtract( it->second, child );
+        }
+    }
+}
+
+// Must be called with the registry locked
+merged_node merge_all( const timer_registry &registry )
+{
+    merged_node root = registry.retired;
+    for( const thread_timers *timers : registry.threads ) {
+        merge( root, timers->nodes.front() );
+    }
+    return root;
+}
+
+bool is_empty( const merged_node &node )
+{
+    return node.count == 0 && std::all_of( node.children.begin(), node.children.end(),
+    []( const std::pair<const scope_id, merged_node> &child ) {
+        return is_empty( child.second );
+    } );
+}
+
+// Must be called with the registry locked
+void to_stats( const timer_registry &registry, const merged_node &from, double tick_rate,
+               cata_timer::timers_map &into )
+{
+    for( const auto &[id, child] : from.children ) {
+        // Scopes that haven't been entered since the last reset
+        if( is_empty( child ) ) {
+            continue;
+        }
+        const std::string &name = registry.names[id];
+        cata_timer::timer_stats &stats = into.emplace( name, cata_timer::timer_stats{ name } ).first->second;
+        stats.duration += static_cast<uint64_t>( static_cast<double>( child.ticks ) / tick_rate );
+        stats.count += child.count;
+        to_stats( registry, child, tick_rate, stats.child_timers );
+    }
+}
+
+} // namespace
+
+double ticks_per_us()
 {
-    static cata_timer::timers_map map;
-    return map;
+    // Calibrated once, too short an interval makes for a poor estimate so wait a little
+    // if the registry was only just created.
+    static const double rate = []() {
+        const timer_registry &registry = get_registry();
+        std::chrono::steady_clock::time_point now;
+        uint64_t now_ticks;
+        do {
+            now = std::chrono::steady_clock::now();
+            now_ticks = ticks();
+        } while( now - registry.calibration_start < std::chrono::milliseconds( 10 ) );
+        const double elapsed_us = std::chrono::duration<double, std::micro>( now -
+                                  registry.calibration_start ).count();
+        return static_cast<double>( now_ticks - registry.calibration_start_ticks ) / elapsed_us;
+    }();
+    return rate;
 }
 
-std::vector<cata_timer::timers_map::iterator> &cata_timer::timer_stack()
+scope_id register_scope( std::string_view name )
 {
-    static std::vector<cata_timer::timers_map::iterator> stack;
-    return stack;
+    timer_registry &registry = get_registry();
+    std::lock_guard<std::mutex> lock( registry.mutex );
+    const auto it = registry.ids.find( name );
+    if( it != registry.ids.end() ) {
+        return it->second;
+    }
+    if( registry.names.size() > std::numeric_limits<scope_id>::max() ) {
+        debugmsg( "Too many timer scopes, can't register %s", name );
+        return root_scope;
+    }
+    const scope_id id = static_cast<scope_id>( registry.names.size() );
+    registry.names.emplace_back( name );
+    registry.ids.emplace( name, id );
+    return id;
+}
+
+std::string scope_name( scope_id id )
+{
+    timer_registry &registry = get_registry();
+    std::lock_guard<std::mutex> lock( registry.mutex );
+    return registry.names[id];
+}
+
+thread_timers::thread_timers()
+{
+    timer_registry &registry = get_registry();
+    std::lock_guard<std::mutex> lock( registry.mutex );
+    nodes.emplace_back( root_scope );
+    registry.threads.push_back( this );
+}
+
+thread_timers::~thread_timers()
+{
+    timer_registry &registry = get_registry();
+    std::lock_guard<std::mutex> lock( registry.mutex );
+    merge( registry.retired, nodes.front() );
+    registry.threads.erase( std::find( registry.threads.begin(), registry.threads.end(), this ) );
+}
+
+timer_node &thread_timers::add_child( timer_node &parent, scope_id id )
+{
+    timer_registry &registry = get_registry();
+    std::lock_guard<std::mutex> lock( registry.mutex );
+    timer_node &child = nodes.emplace_back( id );
+    parent.children.emplace_back( id, &child );
+    return child;
+}
+
+thread_timers &local_timers()
+{
+    thread_local thread_timers timers;
+    return timers;
+}
+
+} // namespace cata_perf
+
+void cata_timer::timer_stats::print_stats_recursively( std::string_view prefix ) const
+{
+    DebugLog( DebugLevel::D_WARNING,
+              D_MAIN ) << prefix << name << ": " << std::to_string( duration ) << "us (avg: " << std::to_string(
+                           count ? duration / count : 0 ) << "us) (count: " << count << ")";
+    std::string child_prefix;
+    child_prefix.reserve( prefix.length() + 2 );
+    child_prefix += prefix;
+    child_prefix += "  ";
+    for( const auto& [name, timer] : child_timers ) {
+        timer.print_stats_recursively( child_prefix );
+    }
+}
+
+cata_timer::timers_map cata_timer::get_stats()
+{
+    const double tick_rate = cata_perf::ticks_per_us();
+    cata_perf::timer_registry &registry = cata_perf::get_registry();
+    std::lock_guard<std::mutex> lock( registry.mutex );
+    cata_perf::merged_node root = cata_perf::merge_all( registry );
+    cata_perf::subtract( root, registry.baseline );
+    timers_map ret;
+    cata_perf::to_stats( registry, root, tick_rate, ret );
+    return ret;
+}
+
+void cata_timer::print_stats()
+{
+    for( const auto& [name, timer] : get_stats() ) {
+        timer.print_stats_recursively();
+    }
+}
+
+void cata_timer::reset_stats()
+{
+    cata_perf::timer_registry &registry = cata_perf::get_registry();
+    std::lock_guard<std::mutex> lock( registry.mutex );
+    // Only the owning thread writes its counters, zeroing them from here could lose a reset
+    // to a timer that is leaving at the same time.  Remember where they were instead.
+    registry.baseline = cata_perf::merge_all( registry );
+}
+
+namespace io
+{
+
+template<>
+std::string enum_to_string<turn_phase>( turn_phase data )
+{
+    switch( data ) {
+        // *INDENT-OFF*
+        case turn_phase::move_hordes: return "move_hordes";
+        case turn_phase::autosave: return "autosave";
+        case turn_phase::scent_update: return "scent_update";
+        case turn_phase::vehmove: return "vehmove";
+        case turn_phase::process_fields: return "process_fields";
+        case turn_phase::process_items: return "process_items";
+        case turn_phase::process_sounds: return "process_sounds";
+        case turn_phase::build_map_cache: return "build_map_cache";
+        case turn_phase::monmove: return "monmove";
+        // *INDENT-ON*
+        case turn_phase::last:
+            break;
+    }
+    cata_fatal( "Invalid turn_phase" );
+}
+
+} // namespace io
+
+cata_perf::scope_id turn_phase_scope( turn_phase phase )
+{
+    static const std::array<cata_perf::scope_id, turn_profiler::num_phases> scopes = []() {
+        std::array<cata_perf::scope_id, turn_profiler::num_phases> ret;
+        for( size_t i = 0; i < turn_profiler::num_phases; ++i ) {
+            ret[i] = cata_perf::register_scope( "turn_phase::" + io::enum_to_string(
+                                                    static_cast<turn_phase>( i ) ) );
+        }
+        return ret;
+    }();
+    return scopes[static_cast<size_t>( phase )];
+}
+
+turn_profiler &get_turn_profiler()
+{
+    static turn_profiler profiler;
+    return profiler;
+}
+
+uint64_t turn_profiler::turn_record::total_us() const
+{
+    return std::accumulate( phase_us.begin(), phase_us.end(), uint64_t( 0 ) );
+}
+
+void turn_profiler::start_turn( int turn )
+{
+    current = turn_record();
+    current.turn = turn;
+    in_turn = true;
+}
+
+void turn_profiler::add_sample( turn_phase phase, uint64_t us )
+{
+    if( in_turn ) {
+        current.phase_us[static_cast<size_t>( phase )] += us;
+    }
+}
+
+void turn_profiler::finish_turn()
+{
+    if( !in_turn ) {
+        return;
+    }
+    history[next] = current;
+    next = ( next + 1 ) % history_size;
+    count = std::min( count + 1, history_size );
+    in_turn = false;
+}
+
+void turn_profiler::discard_turn()
+{
+    in_turn = false;
+}
+
+void turn_profiler::clear()
+{
+    next = 0;
+    count = 0;
+    in_turn = false;
+}
+
+size_t turn_profiler::size() const
+{
+    return count;
+}
+
+const turn_profiler::turn_record &turn_profiler::get_record( size_t age ) const
+{
+    cata_assert( age < count );
+    return history[( next + history_size - 1 - age ) % history_size];
+}
+
+template<typename F>
+turn_profiler::phase_stats turn_profiler::compute_stats( F &&get_value ) const
+{
+    phase_stats ret;
+    if( count == 0 ) {
+        return ret;
+    }
+    std::vector<uint64_t> values;
+    values.reserve( count );
+    for( size_t age = 0; age < count; ++age ) {
+        values.push_back( get_value( get_record( age ) ) );
+    }
+    ret.last = values.front();
+    std::sort( values.begin(), values.end() );
+    // Nearest-rank percentiles
+    const auto percentile = [&values]( size_t pct ) {
+        const size_t rank = ( pct * values.size() + 99 ) / 100;
+        return values[std::max<size_t>( rank, 1 ) - 1];
+    };
+    ret.p50 = percentile( 50 );
+    ret.p99 = percentile( 99 );
+    ret.max = values.back();
+    return ret;
+}
+
+turn_profiler::phase_stats turn_profiler::get_stats( turn_phase phase ) const
+{
+    const size_t idx = static_cast<size_t>( phase );
+    return compute_stats( [idx]( const turn_record & rec ) {
+        return rec.phase_us[idx];
+    } );
+}
+
+turn_profiler::phase_stats turn_profiler::get_total_stats() const
+{
+    return compute_stats( []( const turn_record & rec ) {
+        return rec.total_us();
+    } );
+}
+
+void turn_profiler::write_csv( std::ostream &out ) const
+{
+    out << "turn";
+    for( size_t i = 0; i < num_phases; ++i ) {
+        out << ',' << io::enum_to_string( static_cast<turn_phase>( i ) );
+    }
+    out << ",total\n";
+    for( size_t age = count; age-- > 0; ) {
+        const turn_record &rec = get_record( age );
+        out << rec.turn;
+        for( const uint64_t us : rec.phase_us ) {
+            out << ',' << us;
+        }
+        out << ',' << rec.total_us() << '\n';
+    }
+}
+
+void turn_profiler::serialize( JsonOut &jsout ) const
+{
+    const auto write_stats = [&jsout]( const phase_stats & stats ) {
+        jsout.start_object();
+        jsout.member( "last", stats.last );
+        jsout.member( "p50", stats.p50 );
+        jsout.member( "p99", stats.p99 );
+        jsout.member( "max", stats.max );
+        jsout.end_object();
+    };
+
+    jsout.start_object();
+    jsout.member( "turns", count );
+    jsout.member( "stats" );
+    jsout.start_object();
+    for( size_t i = 0; i < num_phases; ++i ) {
+        const turn_phase phase = static_cast<turn_phase>( i );
+        jsout.member( io::enum_to_string( phase ) );
+        write_stats( get_stats( phase ) );
+    }
+    jsout.member( "total" );
+    write_stats( get_total_stats() );
+    jsout.end_object();
+
+    jsout.member( "history" );
+    jsout.start_array();
+    for( size_t age = count; age-- > 0; ) {
+        const turn_record &rec = get_record( age );
+        jsout.start_object();
+        jsout.member( "turn", rec.turn );
+        for( size_t i = 0; i < num_phases; ++i ) {
+            jsout.member( io::enum_to_string( static_cast<turn_phase>( i ) ), rec.phase_us[i] );
+        }
+        jsout.end_object();
+    }
+    jsout.end_array();
+    jsout.end_object();
 }
@@ -4,7 +4,11 @@
 
 #include <stdint.h>
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -13,71 +17,269 @@
 #include <utility>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
 #include "debug.h"
 
-struct cata_timer {
+class JsonOut;
+template <typename E> struct enum_traits;
+
+namespace cata_perf
+{
+
+using scope_id = uint16_t;
+
+/**
+ * Returns the id for a named timer scope, creating it on first use.  Thread-safe.
+ * Prefer CATA_TIMER_SCOPE, which only does this lookup once per call site.
+ */
+scope_id register_scope( std::string_view name );
+std::string scope_name( scope_id id );
+
+/**
+ * Cheapest monotonic timestamp available.  The unit is unspecified; it is converted
+ * to microseconds at report time by calibrating against steady_clock.
+ */
+inline uint64_t ticks()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+/** Rate of ticks(), measured once on first use. */
+double ticks_per_us();
+
+struct timer_node;
+
+/**
+ * Call tree of the timers entered on one thread.  Only the owning thread ever
+ * writes the counters, so they are updated without read-modify-write atomics;
+ * structural changes happen under the global registry lock so reports from
+ * other threads can walk the tree safely.
+ */
+struct thread_timers {
+    thread_timers();
+    ~thread_timers();
+    thread_timers( const thread_timers & ) = delete;
+    thread_timers &operator=( const thread_timers & ) = delete;
+
+    timer_node &child_of( timer_node &parent, scope_id id );
+    timer_node &add_child( timer_node &parent, scope_id id );
+
+    std::deque<timer_node> nodes;
+    // Open scopes on this thread and their start times
+    std::vector<std::pair<timer_node *, uint64_t>> stack;
+};
+
+struct timer_node {
+    explicit timer_node( scope_id id ) : id( id ) {}
+    scope_id id;
+    std::atomic<uint64_t> ticks{ 0 };
+    std::atomic<uint64_t> count{ 0 };
+    std::vector<std::pair<scope_id, timer_node *>> children;
+};
+
+thread_timers &local_timers();
+
+// NOLINTNEXTLINE(cata-large-inline-function)
+inline timer_node &thread_timers::child_of( timer_node &parent, scope_id id )
+{
+    for( const std::pair<scope_id, timer_node *> &child : parent.children ) {
+        if( child.first == id ) {
+            return *child.second;
+        }
+    }
+    return add_child( parent, id );
+}
+
+inline void enter( scope_id id )
+{
+    thread_timers &timers = local_timers();
+    timer_node &parent = timers.stack.empty() ? timers.nodes.front() : *timers.stack.back().first;
+    timers.stack.emplace_back( &timers.child_of( parent, id ), ticks() );
+}
+
+/** Closes the innermost scope entered on this thread, returns the ticks spent in it. */
+inline uint64_t leave()
+{
+    const uint64_t end = ticks();
+    thread_timers &timers = local_timers();
+    const auto [node, start] = timers.stack.back();
+    timers.stack.pop_back();
+    // Relaxed load/store rather than fetch_add: this thread is the only writer.
+    node->ticks.store( node->ticks.load( std::memory_order_relaxed ) + ( end - start ),
+                       std::memory_order_relaxed );
+    node->count.store( node->count.load( std::memory_order_relaxed ) + 1,
+                       std::memory_order_relaxed );
+    return end - start;
+}
+
+} // namespace cata_perf
+
+/**
+ * Scoped timer.  Nested timers are reported as children of the enclosing one.
+ * Timings from all threads, including ones that have exited, are merged by
+ * name path when reporting.  Cheap enough (tens of nanoseconds) to leave in
+ * release builds when constructed through CATA_TIMER_SCOPE.
+ */
+class cata_timer
+{
+    public:
         struct timer_stats {
             std::string name;
-            std::chrono::high_resolution_clock::time_point current_start;
+            // Microseconds
             uint64_t duration = 0;
             uint64_t count = 0;
             std::map<std::string, timer_stats, std::less<>> child_timers;
 
             explicit timer_stats( std::string_view name ) : name{ name } {}
 
-            void print_stats_recursively( std::string_view prefix = "" ) const {
-                DebugLog( DebugLevel::D_WARNING,
-                          D_MAIN ) << prefix << name << ": " << std::to_string( duration ) << "us (avg: " << std::to_string(
-                                       duration / count ) << "us) (count: " << count << ")";
-                std::string child_prefix;
-                child_prefix.reserve( prefix.length() + 2 );
-                child_prefix += prefix;
-                child_prefix += "  ";
-                for( const auto& [name, timer] : child_timers ) {
-                    timer.print_stats_recursively( child_prefix );
-                }
-            }
+            void print_stats_recursively( std::string_view prefix = "" ) const;
         };
 
         using timers_map = std::map<std::string, timer_stats, std::less<>>;
 
-        // NOLINTNEXTLINE(cata-large-inline-function)
-        explicit cata_timer( std::string_view name ) {
-            timers_map &timer_map = ( [&]() -> timers_map& {
-                if( timer_stack().empty() ) {
-                    return top_level_timer_map();
-                } else {
-                    return timer_stack().back()->second.child_timers;
-                }
-            } )();
-            timer = timer_map.find( name );
-            if( timer == timer_map.end() ) {
-                timer = timer_map.emplace( name, timer_stats{ name } ).first;
-            }
-            timer_stack().push_back( timer );
-            timer->second.current_start = std::chrono::high_resolution_clock::now();
+        explicit cata_timer( std::string_view name ) : cata_timer( cata_perf::register_scope( name ) ) {}
+        explicit cata_timer( cata_perf::scope_id id ) {
+            cata_perf::enter( id );
         }
-
+        cata_timer( const cata_timer & ) = delete;
+        cata_timer &operator=( const cata_timer & ) = delete;
         ~cata_timer() {
-            std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
-            timer->second.duration += std::chrono::duration_cast<std::chrono::microseconds>( (
-                                          end - current_start ) ).count();
-            ++timer->second.count;
-            timer_stack().pop_back();
+            cata_perf::leave();
         }
 
-        static void print_stats() {
-            for( const auto& [name, timer] : top_level_timer_map() ) {
-                timer.print_stats_recursively();
-            }
-        }
+        /** Merged timings of every thread, keyed by top level timer name. */
+        static timers_map get_stats();
+        static void print_stats();
+        /**
+         * Reports only count what is recorded after this; open scopes keep running.
+         * Safe to call while other threads are timing.
+         */
+        static void reset_stats();
+};
+
+#define CATA_TIMER_CONCAT_IMPL( a, b ) a##b
+#define CATA_TIMER_CONCAT( a, b ) CATA_TIMER_CONCAT_IMPL( a, b )
+
+/** Times the rest of the enclosing block, registering @p name only once. */
+#define CATA_TIMER_SCOPE( name ) \
+    static const cata_perf::scope_id CATA_TIMER_CONCAT( cata_timer_id_, __LINE__ ) = \
+            cata_perf::register_scope( name ); \
+    cata_timer CATA_TIMER_CONCAT( cata_timer_, __LINE__ )( CATA_TIMER_CONCAT( cata_timer_id_, __LINE__ ) )
+
+/** The parts of do_turn() whose cost is recorded by the turn_profiler. */
+enum class turn_phase : int {
+    move_hordes,
+    autosave,
+    scent_update,
+    vehmove,
+    process_fields,
+    process_items,
+    process_sounds,
+    build_map_cache,
+    monmove,
+    last
+};
+
+template<>
+struct enum_traits<turn_phase> {
+    static constexpr turn_phase last = turn_phase::last;
+};
+
+/**
+ * Keeps the per-phase timings of the most recent turns in a ring buffer, so that
+ * the subsystem responsible for a slow turn can be found without an external profiler.
+ * All durations are in microseconds.
+ */
+class turn_profiler
+{
+    public:
+        static constexpr size_t history_size = 1000;
+        static constexpr size_t num_phases = static_cast<size_t>( turn_phase::last );
+
+        struct turn_record {
+            // Value of calendar::turn when the turn started, in turns since the epoch.
+            int turn = 0;
+            std::array<uint64_t, num_phases> phase_us = {};
+            uint64_t total_us() const;
+        };
+
+        struct phase_stats {
+            uint64_t last = 0;
+            uint64_t p50 = 0;
+            uint64_t p99 = 0;
+            uint64_t max = 0;
+        };
+
+        /** Starts a new record, discarding a previous one that was never finished. */
+        void start_turn( int turn );
+        /** Adds time to a phase of the turn in progress; phases may be entered more than once. */
+        void add_sample( turn_phase phase, uint64_t us );
+        /** Commits the turn in progress to the history. */
+        void finish_turn();
+        /** Drops the turn in progress, for a turn that was interrupted. */
+        void discard_turn();
+        void clear();
+
+        /** Number of finished turns in the history. */
+        size_t size() const;
+        /** @param age 0 is the most recently finished turn. */
+        const turn_record &get_record( size_t age ) const;
+
+        /** Statistics over the history for a single phase. */
+        phase_stats get_stats( turn_phase phase ) const;
+        /** Statistics over the history for the sum of all phases. */
+        phase_stats get_total_stats() const;
+
+        /** One row per turn, oldest first, with a column per phase. */
+        void write_csv( std::ostream &out ) const;
+        /** Per-phase statistics followed by the raw history, oldest first. */
+        void serialize( JsonOut &jsout ) const;
+
     private:
-        timers_map::iterator timer;
-        std::chrono::high_resolution_clock::time_point current_start =
-            std::chrono::high_resolution_clock::now();
+        template<typename F>
+        phase_stats compute_stats( F &&get_value ) const;
+
+        std::array<turn_record, history_size> history;
+        // Index in history the next finished turn will be written to.
+        size_t next = 0;
+        size_t count = 0;
+        turn_record current;
+        bool in_turn = false;
+};
 
-        static timers_map &top_level_timer_map();
-        static std::vector<timers_map::iterator> &timer_stack();
+turn_profiler &get_turn_profiler();
+
+/** The cata_timer scope of each turn phase, named after the phase. */
+cata_perf::scope_id turn_phase_scope( turn_phase phase );
+
+/**
+ * A cata_timer scope for a phase of the turn, that also adds its lifetime to the
+ * phase in the turn in progress.
+ */
+class turn_phase_timer
+{
+    public:
+        explicit turn_phase_timer( turn_phase phase ) : phase( phase ) {
+            cata_perf::enter( turn_phase_scope( phase ) );
+        }
+        turn_phase_timer( const turn_phase_timer & ) = delete;
+        turn_phase_timer &operator=( const turn_phase_timer & ) = delete;
+        ~turn_phase_timer() {
+            const uint64_t elapsed = cata_perf::leave();
+            get_turn_profiler().add_sample( phase, static_cast<uint64_t>( static_cast<double>( elapsed ) /
+                                            cata_perf::ticks_per_us() ) );
+        }
+    private:
+        turn_phase phase;
 };
 
 #endif // CATA_SRC_PERF_H
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <fstream>
 #include <map>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -23,6 +24,7 @@
 #include "faction.h"
 #include "hash_utils.h"
 #include "horde_entity.h"
+#include "horde_map.h"
 #include "input.h"
 #include "json.h"
 #include "json_loader.h"
@@ -346,6 +348,7 @@ void scent_map::deserialize( const std::string &data, bool is_type )
                 val = stmp;
             }
         }
+        scented_area = all_squares;
     }
 }
 
@@ -660,26 +663,27 @@ void overmap::unserialize( const JsonObject &jsobj )
             JsonArray monster_map_json = om_member;
             while( monster_map_json.has_more() ) {
                 tripoint_abs_ms monster_location;
-                std::optional<std::unordered_map<tripoint_abs_ms, horde_entity>::iterator> result;
+                std::optional<horde_entity> entity;
                 monster_location.deserialize( monster_map_json.next_value() );
-                point_abs_om omp;
-                tripoint_om_sm monster_submap;
-                std::tie( omp, monster_submap ) = project_remain<coords::om>( project_to<coords::sm>
-                                                  ( monster_location ) );
                 if( monster_map_json.test_string() ) {
                     mtype_id monster_id( monster_map_json.next_string() );
-                    result = hordes.spawn_entity( monster_location, monster_id );
+                    // Skip blacklisted or removed monsters.
+                    if( !monster_id.is_null() && monster_id.is_valid() ) {
+                        entity.emplace( monster_id );
+                    }
                 } else {
                     monster new_monster;
                     new_monster.deserialize( monster_map_json.next_object() );
-                    result = hordes.spawn_entity( monster_location, new_monster );
+                    new_monster.set_pos_abs_only( monster_location );
+                    entity.emplace( new_monster );
                 }
 
-                if( result.has_value() ) {
-                    ( *result )->second.destination.deserialize( monster_map_json.next_value() );
-                    ( *result )->second.tracking_intensity = monster_map_json.next_int();
-                    ( *result )->second.last_processed.deserialize( monster_map_json.next_value() );
-                    ( *result )->second.moves = monster_map_json.next_int();
+                if( entity.has_value() ) {
+                    entity->destination.deserialize( monster_map_json.next_value() );
+                    entity->tracking_intensity = monster_map_json.next_int();
+                    entity->last_processed.deserialize( monster_map_json.next_value() );
+                    entity->moves = monster_map_json.next_int();
+                    hordes.insert( monster_location, std::move( *entity ) );
                 } else {
                     // We deserialized something nasty, skip the rest of the stored values
                     monster_map_json.next_value();
@@ -1446,18 +1450,18 @@ void overmap::serialize( std::ostream &fout ) const
 
     json.member( "horde_map" );
     json.start_array();
-    for( const auto &monster_entry : hordes ) {
+    for( const horde_entity_ref monster_entry : hordes ) {
         // Consider projecting this to tripoint_om_ms which will be slightly smaller.
-        monster_entry.first.serialize( json );
-        if( monster_entry.second.monster_data ) {
-            monster_entry.second.monster_data->serialize( json );
+        monster_entry.pos().serialize( json );
+        if( const monster *monster_data = monster_entry.monster_data() ) {
+            monster_data->serialize( json );
         } else {
-            json.write( monster_entry.second.type_id->id.str() );
+            json.write( monster_entry.type_id()->id.str() );
         }
-        monster_entry.second.destination.serialize( json );
-        json.write( monster_entry.second.tracking_intensity );
-        monster_entry.second.last_processed.serialize( json );
-        json.write( monster_entry.second.moves );
+        monster_entry.destination().serialize( json );
+        json.write( monster_entry.tracking_intensity() );
+        monster_entry.last_processed().serialize( json );
+        json.write( monster_entry.moves() );
     }
     json.end_array();
     fout << std::endl;
@@ -2023,7 +2027,7 @@ void faction_manager::deserialize( const JsonValue &jv )
 void creature_tracker::deserialize( const JsonArray &ja )
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    clear_locations();
     for( JsonValue jv : ja ) {
         // TODO: would be nice if monster had a constructor using JsonIn or similar, so this could be one statement.
         shared_ptr_fast<monster> mptr = make_shared_fast<monster>();
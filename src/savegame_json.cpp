@@ -5328,6 +5328,7 @@ void submap::load( const JsonValue &jv, const std::string &member_name, int vers
                     } else if( ft != field_type_str_id::NULL_ID() &&
                                m->fld[i][j].add_field( ft.id(), intensity, time_duration::from_turns( age ), source ) ) {
                         field_count++;
+                        mark_field_square( { i, j } );
                     }
                 }
             }
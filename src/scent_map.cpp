@@ -53,6 +53,7 @@ void scent_map::reset()
             val = 0;
         }
     }
+    scented_area = inclusive_rectangle<point_bub_ms>( all_squares.p_max, all_squares.p_min );
     typescent = scenttype_id();
 }
 
@@ -95,6 +96,12 @@ void scent_map::shift( const point_rel_ms &sm_shift )
             grscent[x][y] = inbounds( p ) ? grscent[p.x()][p.y()] : 0;
         }
     }
+    if( scented_area.p_min.x() <= scented_area.p_max.x() ) {
+        scented_area.p_min = point_bub_ms( std::max( scented_area.p_min.x() - sm_shift.x(), 0 ),
+                                           std::max( scented_area.p_min.y() - sm_shift.y(), 0 ) );
+        scented_area.p_max = point_bub_ms( std::min( scented_area.p_max.x() - sm_shift.x(), MAPSIZE_X - 1 ),
+                                           std::min( scented_area.p_max.y() - sm_shift.y(), MAPSIZE_Y - 1 ) );
+    }
 }
 
 int scent_map::get( const tripoint_bub_ms &p ) const
@@ -115,6 +122,12 @@ void scent_map::set( const tripoint_bub_ms &p, int value, const scenttype_id &ty
 void scent_map::set_unsafe( const tripoint_bub_ms &p, int value, const scenttype_id &type )
 {
     grscent[p.x()][p.y()] = value;
+    if( value > 0 ) {
+        scented_area.p_min = point_bub_ms( std::min( scented_area.p_min.x(), p.x() ),
+                                           std::min( scented_area.p_min.y(), p.y() ) );
+        scented_area.p_max = point_bub_ms( std::max( scented_area.p_max.x(), p.x() ),
+                                           std::max( scented_area.p_max.y(), p.y() ) );
+    }
     if( !type.is_empty() ) {
         typescent = type;
     }
@@ -177,24 +190,24 @@ void scent_map::update( const tripoint_bub_ms &center, map &m )
         return;
     }
 
-    // note: the next four intermediate matrices need to be at least
+    // for loop constants.  Scent spreads one square per update at most, so only the squares
+    // next to those with scent can change.
+    const int scentmap_minx = std::max( center.x() - SCENT_RADIUS, scented_area.p_min.x() - 1 );
+    const int scentmap_maxx = std::min( center.x() + SCENT_RADIUS, scented_area.p_max.x() + 1 );
+    const int scentmap_miny = std::max( center.y() - SCENT_RADIUS, scented_area.p_min.y() - 1 );
+    const int scentmap_maxy = std::min( center.y() + SCENT_RADIUS, scented_area.p_max.y() + 1 );
+    if( scentmap_minx > scentmap_maxx || scentmap_miny > scentmap_maxy ) {
+        return;
+    }
+
+    // note: the intermediate matrices need to be at least
     // [2*SCENT_RADIUS+3][2*SCENT_RADIUS+1] in size to hold enough data
     // The code I'm modifying used [MAPSIZE_X]. I'm staying with that to avoid new bugs.
 
-    // These two matrices are transposed so that x addresses are contiguous in memory
-    scent_array<int> sum_3_scent_y;
-    scent_array<int> squares_used_y;
-
     // these are for caching flag lookups
     scent_array<bool> blocks_scent; // currently only ter_furn_flag::TFLAG_NO_SCENT blocks scent
     scent_array<bool> reduces_scent;
 
-    // for loop constants
-    const int scentmap_minx = center.x() - SCENT_RADIUS;
-    const int scentmap_maxx = center.x() + SCENT_RADIUS;
-    const int scentmap_miny = center.y() - SCENT_RADIUS;
-    const int scentmap_maxy = center.y() + SCENT_RADIUS;
-
     // decrease this to reduce gas spread. Keep it under 125 for
     // stability. This is essentially a decimal number * 1000.
     const int diffusivity = 100;
@@ -202,67 +215,85 @@ void scent_map::update( const tripoint_bub_ms &center, map &m )
     // The new scent flag searching function. Should be wayyy faster than the old one.
     m.scent_blockers( blocks_scent, reduces_scent, point_bub_ms( scentmap_minx - 1, scentmap_miny - 1 ),
                       point_bub_ms( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+
+    // How much scent each square lets through: none on NO_SCENT squares, and only 20% of it
+    // on REDUCE_SCENT squares.  Having it as a number keeps the loops below free of branches,
+    // so they vectorize.
+    scent_array<int> spread_weight;
+    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
+        for( int y = scentmap_miny - 1; y <= scentmap_maxy + 1; ++y ) {
+            spread_weight[x][y] = blocks_scent[x][y] ? 0 : reduces_scent[x][y] ? 2 : 10;
+        }
+    }
+
     // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
     // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
-    // is a net performance improvement over the old code. Could probably still be better.
+    // is a net performance improvement over the old code.  All the matrices share the layout of
+    // grscent, so the inner loops walk contiguous memory.
     // note: this method needs an array that is one square larger on each side in the x direction
     // than the final scent matrix. I think this is fine since SCENT_RADIUS is less than
     // MAPSIZE_X, but if that changes, this may need tweaking.
+    scent_array<int> sum_3_scent_y;
+    scent_array<int> squares_used_y;
     for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
+        const std::array<int, MAPSIZE_Y> &weight = spread_weight[x];
+        const std::array<int, MAPSIZE_Y> &scent = grscent[x];
         for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
             // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = y - 1; i <= y + 1; ++i ) {
-                if( !blocks_scent[x][i] ) {
-                    if( reduces_scent[x][i] ) {
-                        // only 20% of scent can diffuse on REDUCE_SCENT squares
-                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
-                        squares_used_y[y][x] += 2;
-                    } else {
-                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
-                        squares_used_y[y][x] += 10;
-                    }
-                }
-            }
+            sum_3_scent_y[x][y] = weight[y - 1] * scent[y - 1] + weight[y] * scent[y] +
+                                  weight[y + 1] * scent[y + 1];
+            squares_used_y[x][y] = weight[y - 1] + weight[y] + weight[y + 1];
         }
     }
 
     // Rest of the scent map
     for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
         for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
-            int &scent_here = grscent[x][y];
-            if( !blocks_scent[x][y] ) {
-                // to how many neighboring squares do we diffuse out? (include our own square
-                // since we also include our own square when diffusing in)
-                const int squares_used = squares_used_y[y][x - 1]
-                                         + squares_used_y[y][x]
-                                         + squares_used_y[y][x + 1];
-
-                int this_diffusivity;
-                if( !reduces_scent[x][y] ) {
-                    this_diffusivity = diffusivity;
-                } else {
-                    this_diffusivity = diffusivity / 5; //less air movement for REDUCE_SCENT square
-                }
-                // take the old scent and subtract what diffuses out
-                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
-                // neighboring REDUCE_SCENT squares absorb some scent
-                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
-                // we've already summed neighboring scent values in the y direction in the previous
-                // loop. Now we do it for the x direction, multiply by diffusion, and this is what
-                // diffuses into our current square.
-                scent_here =
-                    ( temp_scent
-                      + this_diffusivity * ( sum_3_scent_y[y][x - 1]
-                                             + sum_3_scent_y[y][x]
-                                             + sum_3_scent_y[y][x + 1] )
-                    ) / ( 1000 * 10 );
-            } else {
-                // this cell blocks scent via NO_SCENT (in json)
-                scent_here = 0;
-            }
+            // to how many neighboring squares do we diffuse out? (include our own square
+            // since we also include our own square when diffusing in)
+            const int squares_used = squares_used_y[x - 1][y] + squares_used_y[x][y] +
+                                     squares_used_y[x + 1][y];
+            //less air movement for REDUCE_SCENT square
+            const int this_diffusivity = reduces_scent[x][y] ? diffusivity / 5 : diffusivity;
+            const int scent_here = grscent[x][y];
+            // take the old scent and subtract what diffuses out
+            int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+            // neighboring REDUCE_SCENT squares absorb some scent
+            temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+            // we've already summed neighboring scent values in the y direction in the previous
+            // loop. Now we do it for the x direction, multiply by diffusion, and this is what
+            // diffuses into our current square.
+            const int diffused = ( temp_scent + this_diffusivity * ( sum_3_scent_y[x - 1][y] +
+                                   sum_3_scent_y[x][y] + sum_3_scent_y[x + 1][y] ) ) / ( 1000 * 10 );
+            // a cell that blocks scent via NO_SCENT (in json) keeps none
+            grscent[x][y] = blocks_scent[x][y] ? 0 : diffused;
+        }
+    }
+
+    // Scent thins out to nothing at the edges, so rather than only growing the area, find the
+    // squares that still have some.  None can be further out than one square past the old area.
+    const int scan_minx = std::max( scented_area.p_min.x() - 1, 0 );
+    const int scan_maxx = std::min( scented_area.p_max.x() + 1, MAPSIZE_X - 1 );
+    const int scan_miny = std::max( scented_area.p_min.y() - 1, 0 );
+    const int scan_maxy = std::min( scented_area.p_max.y() + 1, MAPSIZE_Y - 1 );
+    scented_area = inclusive_rectangle<point_bub_ms>( all_squares.p_max, all_squares.p_min );
+    for( int x = scan_minx; x <= scan_maxx; ++x ) {
+        const std::array<int, MAPSIZE_Y> &scent = grscent[x];
+        int first = scan_miny;
+        while( first <= scan_maxy && scent[first] == 0 ) {
+            ++first;
+        }
+        if( first > scan_maxy ) {
+            continue;
+        }
+        int last = scan_maxy;
+        while( scent[last] == 0 ) {
+            --last;
         }
+        scented_area.p_min = point_bub_ms( std::min( scented_area.p_min.x(), x ),
+                                           std::min( scented_area.p_min.y(), first ) );
+        scented_area.p_max = point_bub_ms( std::max( scented_area.p_max.x(), x ),
+                                           std::max( scented_area.p_max.y(), last ) );
     }
 }
 
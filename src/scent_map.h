@@ -12,6 +12,7 @@
 
 #include "calendar.h"
 #include "coordinates.h"
+#include "cuboid_rectangle.h"
 #include "enums.h" // IWYU pragma: keep
 #include "map_scale_constants.h"
 #include "type_id.h"
@@ -50,13 +51,20 @@ class scent_map
         template<typename T>
         using scent_array = std::array<std::array<T, MAPSIZE_Y>, MAPSIZE_X>;
 
+        // TODO: Keep a layer per z-level, so monsters on other levels can follow scent there
         scent_array<int> grscent;
+        // Holds every square with scent, so update() can skip the rest.  update() shrinks it to
+        // the squares that still have scent.  It is empty while p_min is past p_max.
+        inclusive_rectangle<point_bub_ms> scented_area = all_squares; // NOLINT(cata-serialize)
         scenttype_id typescent;
         std::optional<tripoint_bub_ms> player_last_position; // NOLINT(cata-serialize)
         time_point player_last_moved = calendar::before_time_starts; // NOLINT(cata-serialize)
 
         const game &gm; // NOLINT(cata-serialize)
 
+        static constexpr inclusive_rectangle<point_bub_ms> all_squares{
+            point_bub_ms::zero, point_bub_ms( MAPSIZE_X - 1, MAPSIZE_Y - 1 ) };
+
     public:
         explicit scent_map( const game &g ) : gm( g ) { }
 
@@ -4,6 +4,10 @@
 #include <cstdlib>
 #include <iterator>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include "coordinates.h"
 #include "cuboid_rectangle.h"
 #include "fragment_cloud.h" // IWYU pragma: keep
@@ -11,6 +15,61 @@
 #include "list.h"
 #include "point.h"
 
+bool shadowcasting_batch_runs = true;
+
+int equal_run_length( const float *first, const int step, const int max_count,
+                      const float &value )
+{
+    int count = 0;
+#if defined(__AVX2__)
+    const __m256 wanted8 = _mm256_set1_ps( value );
+    while( count + 8 <= max_count ) {
+        const float *lanes = step > 0 ? first + count : first - count - 7;
+        unsigned int mask = _mm256_movemask_ps( _mm256_cmp_ps( _mm256_loadu_ps( lanes ), wanted8,
+                                                _CMP_EQ_OQ ) );
+        if( step < 0 ) {
+            // Lane 7 holds the first cell of this batch
+            unsigned int reversed = 0;
+            for( int i = 0; i < 8; ++i ) {
+                reversed |= ( ( mask >> i ) & 1 ) << ( 7 - i );
+            }
+            mask = reversed;
+        }
+        if( mask != 0xff ) {
+            while( mask & 1 ) {
+                ++count;
+                mask >>= 1;
+            }
+            return count;
+        }
+        count += 8;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128 wanted4 = _mm_set1_ps( value );
+    while( count + 4 <= max_count ) {
+        const float *lanes = step > 0 ? first + count : first - count - 3;
+        unsigned int mask = _mm_movemask_ps( _mm_cmpeq_ps( _mm_loadu_ps( lanes ), wanted4 ) );
+        if( step < 0 ) {
+            // Lane 3 holds the first cell of this batch
+            mask = ( ( mask & 1 ) << 3 ) | ( ( mask & 2 ) << 1 ) | ( ( mask & 4 ) >> 1 ) | ( mask >> 3 );
+        }
+        if( mask != 0xf ) {
+            while( mask & 1 ) {
+                ++count;
+                mask >>= 1;
+            }
+            return count;
+        }
+        count += 4;
+    }
+#endif
+    while( count < max_count && first[count * step] == value ) {
+        ++count;
+    }
+    return count;
+}
+
 // historically 8 bits is enough for rise and run, as a shadowcasting radius of 60
 // readily fits within that space. larger shadowcasting volumes may require larger
 // storage units; a radius of 120 definitely will not fit.
@@ -179,6 +238,7 @@ void cast_horizontal_zlight_segment(
     slope new_start_minor( 1, 1 );
 
     T last_intensity( 0.0 );
+    memoized_calc<T, calc> intensity( numerator );
     tripoint_rel_ms delta;
     tripoint_bub_ms current;
 
@@ -200,6 +260,7 @@ void cast_horizontal_zlight_segment(
 
         for( auto this_span = spans.begin(); this_span != spans.end(); ) {
             bool started_block = false;
+            intensity.reset();
             // TODO: Precalculate min/max delta.z based on start/end and distance
             for( delta.z() = 0; delta.z() <= distance; delta.z()++ ) {
                 // Shadowcasting sweeps from the cardinal to the most extreme edge of the octant
@@ -300,7 +361,7 @@ void cast_horizontal_zlight_segment(
                     }
 
                     const int dist = rl_dist( tripoint_rel_ms::zero, delta ) + offset_distance;
-                    last_intensity = calc( numerator, this_span->cumulative_value, dist );
+                    last_intensity = intensity( this_span->cumulative_value, dist );
 
                     if( !floor_block ) {
                         ( *output_caches[z_index] )[current.x()][current.y()] =
@@ -374,6 +435,7 @@ void cast_vertical_zlight_segment(
     slope new_start_minor( 1, 1 );
 
     T last_intensity( 0.0 );
+    memoized_calc<T, calc> intensity( numerator );
     tripoint_rel_ms delta;
     tripoint_bub_ms current;
 
@@ -395,6 +457,7 @@ void cast_vertical_zlight_segment(
 
         for( auto this_span = spans.begin(); this_span != spans.end(); ) {
             bool started_block = false;
+            intensity.reset();
             for( delta.y() = 0; delta.y() <= distance; delta.y()++ ) {
                 // See comment above trailing_edge_major and leading_edge_major in above function.
                 const slope trailing_edge_major( delta.y() * 2 - 1, delta.z() * 2 + 1 );
@@ -472,7 +535,7 @@ void cast_vertical_zlight_segment(
                     }
 
                     const int dist = rl_dist( tripoint_rel_ms::zero, delta ) + offset_distance;
-                    last_intensity = calc( numerator, this_span->cumulative_value, dist );
+                    last_intensity = intensity( this_span->cumulative_value, dist );
 
                     if( !floor_block ) {
                         ( *output_caches[z_index] )[current.x()][current.y()] =
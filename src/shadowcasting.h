@@ -115,6 +115,51 @@ inline float accumulate_transparency( const float &cumulative_transparency,
     return ( ( distance - 1 ) * cumulative_transparency + current_transparency ) / distance;
 }
 
+// calc() is pure and a shadowcasting row asks it for the same distance tile after tile, so
+// remember the last result.  Call reset() whenever the cumulative transparency changes.
+template<typename T, T( *calc )( const T &, const T &, const int & )>
+class memoized_calc
+{
+    public:
+        explicit memoized_calc( const T &numerator ) : numerator( numerator ) {}
+
+        const T &operator()( const T &cumulative_transparency, const int distance ) {
+            if( distance != last_distance ) {
+                last_distance = distance;
+                last_result = calc( numerator, cumulative_transparency, distance );
+            }
+            return last_result;
+        }
+        void reset() {
+            last_distance = -1;
+        }
+
+    private:
+        T numerator;
+        T last_result = T( 0.0f );
+        int last_distance = -1;
+};
+
+// Counts how many of the max_count cells starting at first and moving by step (1 or -1) equal
+// value.  Shadowcasting spends most of its time walking rows of identical transparency, so the
+// float version compares a batch of cells at a time.
+template<typename T>
+int equal_run_length( const T *first, const int step, const int max_count, const T &value )
+{
+    int count = 0;
+    while( count < max_count && first[count * step] == value ) {
+        ++count;
+    }
+    return count;
+}
+
+// Compares several cells at a time where SIMD is available, see shadowcasting.cpp
+int equal_run_length( const float *first, int step, int max_count, const float &value );
+
+// Whether castLight() lights runs of equal transparency in one go.  Only tests turn this off,
+// to check that doing so doesn't change the result.
+extern bool shadowcasting_batch_runs;
+
 template<typename T, typename Out, T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
          void( *update_output )( Out &, const T &, quadrant ),
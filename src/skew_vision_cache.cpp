@@ -0,0 +1,101 @@
+#include "skew_vision_cache.h"
+
+#include <algorithm>
+
+static uint64_t pack_key( const point &key )
+{
+    return static_cast<uint64_t>( static_cast<uint32_t>( key.x ) ) << 32 |
+           static_cast<uint32_t>( key.y );
+}
+
+// Keys are bit-packed coordinates with most of their bits always zero, so they need
+// a thorough mix before picking a set (splitmix64 finalizer).
+static uint64_t hash_key( uint64_t packed )
+{
+    packed ^= packed >> 30;
+    packed *= 0xbf58476d1ce4e5b9ULL;
+    packed ^= packed >> 27;
+    packed *= 0x94d049bb133111ebULL;
+    packed ^= packed >> 31;
+    return packed;
+}
+
+char skew_vision_cache::get( const point &key, const char default_ )
+{
+    if( !sets ) {
+        return default_;
+    }
+    const uint64_t packed = pack_key( key );
+    const size_t index = hash_key( packed ) % set_count;
+    if( set_epochs[index] != epoch ) {
+        return default_;
+    }
+    entry_set &set = sets[index];
+    for( int i = 0; i < ways; ++i ) {
+        if( set.values[i] >= 0 && set.keys[i] == packed ) {
+            set.referenced |= 1 << i;
+            return set.values[i];
+        }
+    }
+    return default_;
+}
+
+skew_vision_cache::entry_set &skew_vision_cache::set_for( const uint64_t hash )
+{
+    if( !sets ) {
+        sets = std::make_unique<entry_set[]>( set_count );
+        set_epochs = std::make_unique<uint32_t[]>( set_count );
+    }
+    const size_t index = hash % set_count;
+    entry_set &set = sets[index];
+    if( set_epochs[index] != epoch ) {
+        set.values.fill( -1 );
+        set.referenced = 0;
+        set_epochs[index] = epoch;
+    }
+    return set;
+}
+
+void skew_vision_cache::insert( const point &key, const char value )
+{
+    const uint64_t packed = pack_key( key );
+    const uint64_t hash = hash_key( packed );
+    entry_set &set = set_for( hash );
+
+    for( int i = 0; i < ways; ++i ) {
+        if( set.values[i] >= 0 && set.keys[i] == packed ) {
+            set.values[i] = value;
+            return;
+        }
+    }
+    int slot = -1;
+    for( int i = 0; i < ways && slot < 0; ++i ) {
+        if( set.values[i] < 0 ) {
+            slot = i;
+        }
+    }
+    if( slot < 0 ) {
+        // Clock eviction, starting at a point picked by the unused high bits of the hash
+        // rather than a stored hand, which would not fit the cache line.
+        slot = static_cast<int>( ( hash >> 32 ) % ways );
+        while( set.referenced & ( 1 << slot ) ) {
+            set.referenced &= ~( 1 << slot );
+            slot = ( slot + 1 ) % ways;
+        }
+    }
+    // New entries start unreferenced, so one that is never looked up again goes first.
+    set.keys[slot] = packed;
+    set.values[slot] = value;
+    set.referenced &= ~( 1 << slot );
+}
+
+void skew_vision_cache::clear()
+{
+    if( ++epoch == 0 ) {
+        // Wrapped around, so old sets could look current
+        if( set_epochs ) {
+            std::fill( set_epochs.get(), set_epochs.get() + set_count, 0 );
+        }
+        epoch = 1;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#ifndef CATA_SRC_SKEW_VISION_CACHE_H
+#define CATA_SRC_SKEW_VISION_CACHE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "point.h"
+
+/**
+ * Fixed size cache of line of sight results, keyed by map::sees_cache_key().
+ *
+ * Keys hash to a set of a few entries sharing one cache line, and a full set evicts with the
+ * clock algorithm, so neither lookups nor inserts allocate.  The table is only allocated on the
+ * first insert, and clear() just starts a new epoch, which keeps both cheap for the many maps
+ * that never check line of sight.
+ */
+class skew_vision_cache
+{
+    public:
+        /** The cached value for key, or default_ if there is none. */
+        char get( const point &key, char default_ );
+        /** Value must not be negative. */
+        void insert( const point &key, char value );
+        void clear();
+
+        static constexpr size_t set_count = 16384;
+        static constexpr int ways = 7;
+
+    private:
+        struct alignas( 64 ) entry_set {
+            std::array<uint64_t, ways> keys;
+            // Negative for unused entries
+            std::array<int8_t, ways> values;
+            // Bit per entry, set when used since the clock last passed it
+            uint8_t referenced;
+        };
+        static_assert( sizeof( entry_set ) == 64, "entry_set should fill exactly one cache line" );
+
+        // Returns the set for hash, emptied first if it is left over from an older epoch.
+        entry_set &set_for( uint64_t hash );
+
+        std::unique_ptr<entry_set[]> sets;
+        std::unique_ptr<uint32_t[]> set_epochs;
+        uint32_t epoch = 1;
+};
+
+#endif // CATA_SRC_SKEW_VISION_CACHE_H
@@ -23,6 +23,7 @@
 #include "line.h"
 #include "map.h"
 #include "map_iterator.h"
+#include "map_scale_constants.h"
 #include "messages.h"
 #include "monster.h"
 #include "music.h"
@@ -458,9 +459,23 @@ static int get_signal_for_hordes( const centroid &centr )
 void sounds::process_sounds()
 {
     map &here = get_map();
+    const creature_tracker &creatures = get_creature_tracker();
+    // Only monsters in the reality bubble can hear anything
+    const tripoint_abs_ms bubble_min = here.get_abs( tripoint_bub_ms( 0, 0, -OVERMAP_DEPTH ) );
+    const tripoint_abs_ms bubble_max = here.get_abs( tripoint_bub_ms( MAPSIZE_X - 1, MAPSIZE_Y - 1,
+                                       OVERMAP_HEIGHT ) );
 
     std::vector<centroid> sound_clusters = cluster_sounds( recent_sounds );
     const int weather_vol = get_weather().weather_id->sound_attn;
+    // Look up the sound-triggered traps once for all clusters.  This is a copy, as
+    // triggering a trap can remove it from the map's trap lists.
+    std::vector<tripoint_bub_ms> sound_trap_locations;
+    if( !sound_clusters.empty() ) {
+        for( const trap *trapType : trap::get_sound_triggered_traps() ) {
+            const std::vector<tripoint_bub_ms> &locations = here.trap_locations( trapType->id );
+            sound_trap_locations.insert( sound_trap_locations.end(), locations.begin(), locations.end() );
+        }
+    }
     for( const centroid &this_centroid : sound_clusters ) {
         // Since monsters don't go deaf ATM we can just use the weather modified volume
         // If they later get physical effects from loud noises we'll have to change this
@@ -478,24 +493,33 @@ void sounds::process_sounds()
             overmap_buffer.signal_hordes( target, sig_power );
         }
         // Alert all monsters (that can hear) to the sound.
-        for( monster &critter : g->all_monsters() ) {
-            // TODO: Generalize this to Creature::hear_sound
-            const int dist = sound_distance( source, critter.pos_bub() );
-            if( vol * 2 > dist ) {
-                // Exclude monsters that certainly won't hear the sound
-                critter.hear_sound( source, vol, dist, this_centroid.provocative );
+        // Monsters further than vol * 2 certainly won't hear it, and every z-level
+        // of displacement adds at least 5 to the distance.
+        if( vol > 0 ) {
+            const tripoint_abs_ms abs_source = here.get_abs( source );
+            const int reach = vol * 2 - 1;
+            const tripoint_abs_ms min( std::max( abs_source.x() - reach, bubble_min.x() ),
+                                       std::max( abs_source.y() - reach, bubble_min.y() ),
+                                       std::max( abs_source.z() - reach / 5, bubble_min.z() ) );
+            const tripoint_abs_ms max( std::min( abs_source.x() + reach, bubble_max.x() ),
+                                       std::min( abs_source.y() + reach, bubble_max.y() ),
+                                       std::min( abs_source.z() + reach / 5, bubble_max.z() ) );
+            for( monster *critter : creatures.monsters_in( min, max ) ) {
+                // TODO: Generalize this to Creature::hear_sound
+                const int dist = sound_distance( source, critter->pos_bub( here ) );
+                if( vol * 2 > dist ) {
+                    critter->hear_sound( source, vol, dist, this_centroid.provocative );
+                }
             }
         }
         // Trigger sound-triggered traps and ensure they are still valid
-        for( const trap *trapType : trap::get_sound_triggered_traps() ) {
-            for( const tripoint_bub_ms &tp : here.trap_locations( trapType->id ) ) {
-                const int dist = sound_distance( source, tp );
+        for( const tripoint_bub_ms &tp : sound_trap_locations ) {
+            const int dist = sound_distance( source, tp );
+            // Exclude traps that certainly won't hear the sound
+            if( vol * 2 > dist ) {
                 const trap &tr = here.tr_at( tp );
-                // Exclude traps that certainly won't hear the sound
-                if( vol * 2 > dist ) {
-                    if( tr.triggered_by_sound( vol, dist ) ) {
-                        tr.trigger( tp );
-                    }
+                if( tr.triggered_by_sound( vol, dist ) ) {
+                    tr.trigger( tp );
                 }
             }
         }
@@ -27,6 +27,11 @@ void maptile_soa::swap_soa_tile( const point_sm_ms &p1, const point_sm_ms &p2 )
     std::swap( fld[p1.x()][p1.y()], fld[p2.x()][p2.y()] );
     std::swap( trp[p1.x()][p1.y()], trp[p2.x()][p2.y()] );
     std::swap( rad[p1.x()][p1.y()], rad[p2.x()][p2.y()] );
+    const size_t bit1 = p1.x() * SEEY + p1.y();
+    const size_t bit2 = p2.x() * SEEY + p2.y();
+    const bool had_fields1 = field_squares[bit1];
+    field_squares[bit1] = field_squares[bit2];
+    field_squares[bit2] = had_fields1;
 }
 
 submap::submap( submap && ) noexcept( map_is_noexcept ) = default;
@@ -425,6 +430,9 @@ void submap::merge_submaps( submap *copy_from, bool copy_from_is_overlay )
                  it != this->m->fld[x][y].end(); it++ ) {
                 this->field_count++;
             }
+            if( this->m->fld[x][y].field_count() > 0 ) {
+                mark_field_square( { x, y } );
+            }
 
             if( copy_from->m->trp[x][y] != tr_null && ( copy_from_is_overlay ||
                     this->m->trp[x][y] == tr_null ) ) {
@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_SUBMAP_H
 #define CATA_SRC_SUBMAP_H
 
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
@@ -67,6 +68,9 @@ struct maptile_soa {
     cata::mdarray<field, point_sm_ms>              fld; // Field on each square
     cata::mdarray<trap_id, point_sm_ms>            trp; // Trap on each square
     cata::mdarray<int, point_sm_ms>                rad; // Irradiation of each square
+    // Bit x * SEEY + y is set for every square that may have fields, so field processing can
+    // skip the rest.  Squares whose fields are gone are only cleared when processed.
+    std::bitset<SEEX *SEEY>                        field_squares;
 
     void swap_soa_tile( const point_sm_ms &p1, const point_sm_ms &p2 );
 };
@@ -232,6 +236,22 @@ class submap
 
         void clear_fields( const point_sm_ms &p );
 
+        // Must be called whenever a field is put on p, see maptile_soa::field_squares.
+        void mark_field_square( const point_sm_ms &p ) {
+            if( !is_uniform() ) {
+                m->field_squares.set( p.x() * SEEY + p.y() );
+            }
+        }
+        // Empty for uniform submaps, which have no fields.
+        std::bitset<SEEX *SEEY> &get_field_squares() {
+            if( is_uniform() ) {
+                std::bitset<SEEX *SEEY> static no_field_squares;
+                no_field_squares.reset();
+                return no_field_squares;
+            }
+            return m->field_squares;
+        }
+
         struct cosmetic_t {
             point_sm_ms pos;
             std::string type;
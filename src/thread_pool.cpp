@@ -0,0 +1,109 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+thread_pool::thread_pool( unsigned int worker_threads )
+{
+    workers.reserve( worker_threads );
+    for( unsigned int i = 0; i < worker_threads; ++i ) {
+        workers.emplace_back( &thread_pool::work, this );
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    job_posted.notify_all();
+    for( std::thread &worker : workers ) {
+        worker.join();
+    }
+}
+
+size_t thread_pool::worker_count() const
+{
+    return workers.size();
+}
+
+void thread_pool::parallel_for( size_t count, const std::function<void( size_t )> &fn )
+{
+    if( workers.empty() || count <= 1 ) {
+        for( size_t i = 0; i < count; ++i ) {
+            fn( i );
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        job = &fn;
+        job_size = count;
+        next_task = 0;
+        unfinished_tasks = count;
+        ++job_generation;
+    }
+    job_posted.notify_all();
+    run_tasks();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        job_done.wait( lock, [this] {
+            return unfinished_tasks == 0;
+        } );
+        job = nullptr;
+        std::swap( error, first_error );
+    }
+    if( error ) {
+        std::rethrow_exception( error );
+    }
+}
+
+void thread_pool::run_tasks()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    while( job != nullptr && next_task < job_size ) {
+        const size_t task = next_task++;
+        const std::function<void( size_t )> &fn = *job;
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            fn( task );
+        } catch( ... ) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if( error && !first_error ) {
+            first_error = error;
+        }
+        if( --unfinished_tasks == 0 ) {
+            job_done.notify_all();
+        }
+    }
+}
+
+void thread_pool::work()
+{
+    unsigned int last_generation = 0;
+    std::unique_lock<std::mutex> lock( mutex );
+    while( true ) {
+        job_posted.wait( lock, [&] {
+            return stopping || job_generation != last_generation;
+        } );
+        if( stopping ) {
+            return;
+        }
+        last_generation = job_generation;
+        lock.unlock();
+        run_tasks();
+        lock.lock();
+    }
+}
+
+thread_pool &get_thread_pool()
+{
+    static thread_pool pool( std::max( std::thread::hardware_concurrency(), 1U ) - 1 );
+    return pool;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef CATA_SRC_THREAD_POOL_H
+#define CATA_SRC_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+/**
+ * A fixed set of worker threads for splitting a loop of independent iterations across cores.
+ *
+ * The tasks run concurrently, so they must not touch anything shared with each other or with
+ * the rest of the game that may be modified while they run.  Changes to shared state have to be
+ * queued by the tasks and applied by the caller once parallel_for() returns.
+ */
+class thread_pool
+{
+    public:
+        /** A pool without workers runs everything on the calling thread. */
+        explicit thread_pool( unsigned int worker_threads );
+        ~thread_pool();
+
+        thread_pool( const thread_pool & ) = delete;
+        thread_pool &operator=( const thread_pool & ) = delete;
+
+        /**
+         * Calls fn( i ) for every i in [0, count) and returns once all calls are done.
+         * The calling thread takes part in the work.  If any call throws, the first exception
+         * is rethrown here after the remaining calls have finished.
+         * Not reentrant: fn must not call parallel_for() on the same pool.
+         */
+        void parallel_for( size_t count, const std::function<void( size_t )> &fn );
+
+        /** Number of worker threads, not counting the caller of parallel_for(). */
+        size_t worker_count() const;
+
+    private:
+        void work();
+        // Takes tasks of the current job until there are none left.
+        void run_tasks();
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable job_posted;
+        std::condition_variable job_done;
+        const std::function<void( size_t )> *job = nullptr;
+        size_t job_size = 0;
+        size_t next_task = 0;
+        size_t unfinished_tasks = 0;
+        // Incremented for every job, so that workers can tell a new job from the one they did.
+        unsigned int job_generation = 0;
+        bool stopping = false;
+        std::exception_ptr first_error;
+};
+
+/** The shared pool, with one worker per additional hardware thread. */
+thread_pool &get_thread_pool();
+
+#endif // CATA_SRC_THREAD_POOL_H
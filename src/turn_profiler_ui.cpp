@@ -0,0 +1,57 @@
+#include "turn_profiler_ui.h"
+
+#include <imgui/imgui.h>
+#include <cstddef>
+#include <string>
+
+#include "enum_conversions.h"
+#include "perf.h"
+#include "string_formatter.h"
+#include "translations.h"
+
+turn_profiler_ui::turn_profiler_ui() : cataimgui::window( _( "Turn profiler" ),
+            ImGuiWindowFlags_AlwaysAutoResize )
+{
+}
+
+cataimgui::bounds turn_profiler_ui::get_bounds()
+{
+    // Top right corner, out of the way of the sidebar on the left
+    return { ImGui::GetMainViewport()->Size.x - static_cast<float>( str_width_to_pixels( 48 ) ),
+             0.0f, static_cast<float>( str_width_to_pixels( 48 ) ),
+             static_cast<float>( str_height_to_pixels( 14 ) ) };
+}
+
+void turn_profiler_ui::draw_controls()
+{
+    const turn_profiler &profiler = get_turn_profiler();
+    ImGui::TextUnformatted( string_format( _( "Last %d turns, in microseconds" ),
+                                           profiler.size() ).c_str() );
+    if( ImGui::BeginTable( "turn_phases", 5, ImGuiTableFlags_SizingFixedFit ) ) {
+        ImGui::TableSetupColumn( _( "Phase" ) );
+        ImGui::TableSetupColumn( _( "last" ) );
+        ImGui::TableSetupColumn( _( "p50" ) );
+        ImGui::TableSetupColumn( _( "p99" ) );
+        ImGui::TableSetupColumn( _( "max" ) );
+        ImGui::TableHeadersRow();
+
+        const auto row = []( const std::string & label, const turn_profiler::phase_stats & stats ) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted( label.c_str() );
+            for( const uint64_t value : {
+                     stats.last, stats.p50, stats.p99, stats.max
+                 } ) {
+                ImGui::TableNextColumn();
+                ImGui::Text( "%llu", static_cast<unsigned long long>( value ) );
+            }
+        };
+
+        for( size_t i = 0; i < turn_profiler::num_phases; ++i ) {
+            const turn_phase phase = static_cast<turn_phase>( i );
+            row( io::enum_to_string( phase ), profiler.get_stats( phase ) );
+        }
+        row( _( "total" ), profiler.get_total_stats() );
+        ImGui::EndTable();
+    }
+}
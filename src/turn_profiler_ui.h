@@ -0,0 +1,22 @@
+#pragma once
+#ifndef CATA_SRC_TURN_PROFILER_UI_H
+#define CATA_SRC_TURN_PROFILER_UI_H
+
+#include "cata_imgui.h"
+
+/**
+ * Non-modal window drawn on top of the main game UI showing the rolling
+ * per-phase statistics of the turn_profiler.  It stays visible as long as
+ * the object is alive.
+ */
+class turn_profiler_ui : public cataimgui::window
+{
+    public:
+        turn_profiler_ui();
+
+    protected:
+        void draw_controls() override;
+        cataimgui::bounds get_bounds() override;
+};
+
+#endif // CATA_SRC_TURN_PROFILER_UI_H
@@ -0,0 +1,281 @@
+#include "turn_replay.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "avatar.h"
+#include "calendar.h"
+#include "cata_assert.h"
+#include "cata_utility.h"
+#include "debug.h"
+#include "flexbuffer_json.h"
+#include "game.h"
+#include "json.h"
+#include "rng.h"
+#include "string_formatter.h"
+#include "worldfactory.h"
+
+static constexpr int replay_version = 1;
+
+bool turn_replay::is_recording() const
+{
+    return mode == replay_mode::pending || mode == replay_mode::recording;
+}
+
+bool turn_replay::is_replaying() const
+{
+    return mode == replay_mode::replaying;
+}
+
+void turn_replay::request_recording()
+{
+    clear();
+    mode = replay_mode::pending;
+}
+
+bool turn_replay::stop_recording( const std::string &path )
+{
+    const bool started = mode == replay_mode::recording;
+    mode = replay_mode::off;
+    if( !started ) {
+        return false;
+    }
+    return write_to_file( path, [&]( std::ostream & out ) {
+        JsonOut jsout( out );
+        serialize( jsout );
+    }, "turn replay" );
+}
+
+bool turn_replay::begin_turn()
+{
+    if( mode != replay_mode::pending ) {
+        return false;
+    }
+    if( !g->save() ) {
+        debugmsg( "Could not save the game, turn replay recording not started." );
+        mode = replay_mode::off;
+        return false;
+    }
+    world = world_generator->active_world->world_name;
+    save_id = get_avatar().get_save_id();
+    start_turn = to_turns<int>( calendar::turn - calendar::turn_zero );
+    // 0 would leave the engine unseeded
+    seed = std::max( rng_bits(), 1U );
+    rng_set_engine_seed( seed );
+    mode = replay_mode::recording;
+    return true;
+}
+
+void turn_replay::end_turn( uint64_t total_us )
+{
+    if( mode == replay_mode::recording ) {
+        turn_entry entry;
+        entry.rng_check = rng_check();
+        entry.total_us = total_us;
+        entry.actions = std::move( current_actions );
+        current_actions.clear();
+        turns.emplace_back( std::move( entry ) );
+    } else if( mode == replay_mode::replaying && turn_cursor < turns.size() ) {
+        const turn_entry &entry = turns[turn_cursor];
+        if( !divergence && ( entry.rng_check != rng_check() ||
+                             action_cursor != entry.actions.size() ) ) {
+            divergence = turn_cursor;
+        }
+        replay_us.push_back( total_us );
+        ++turn_cursor;
+        action_cursor = 0;
+    }
+}
+
+void turn_replay::record_action( const std::string &action )
+{
+    if( mode == replay_mode::recording ) {
+        current_actions.push_back( action_index( action ) );
+    }
+}
+
+void turn_replay::start_replay()
+{
+    rng_set_engine_seed( seed );
+    turn_cursor = 0;
+    action_cursor = 0;
+    replay_us.clear();
+    divergence.reset();
+    aborted.reset();
+    mode = replay_mode::replaying;
+}
+
+std::string turn_replay::next_action()
+{
+    if( turn_cursor >= turns.size() ) {
+        throw std::runtime_error( "turn replay: no recorded turns left" );
+    }
+    const turn_entry &entry = turns[turn_cursor];
+    if( action_cursor >= entry.actions.size() ) {
+        throw std::runtime_error( string_format(
+                                      "turn replay: diverged at turn %d, the avatar has more moves than recorded",
+                                      start_turn + static_cast<int>( turn_cursor ) ) );
+    }
+    return action_names[entry.actions[action_cursor++]];
+}
+
+bool turn_replay::replay_finished() const
+{
+    return turn_cursor >= turns.size();
+}
+
+size_t turn_replay::replayed_turns() const
+{
+    return turn_cursor;
+}
+
+uint64_t turn_replay::replayed_us( size_t turn ) const
+{
+    return replay_us[turn];
+}
+
+std::optional<size_t> turn_replay::first_divergence() const
+{
+    return divergence;
+}
+
+void turn_replay::abort_replay()
+{
+    if( mode != replay_mode::replaying ) {
+        return;
+    }
+    aborted = turn_cursor;
+    action_cursor = 0;
+    mode = replay_mode::off;
+}
+
+std::optional<size_t> turn_replay::aborted_turn() const
+{
+    return aborted;
+}
+
+void turn_replay::clear()
+{
+    mode = replay_mode::off;
+    world.clear();
+    save_id.clear();
+    start_turn = 0;
+    seed = 0;
+    action_names.clear();
+    action_ids.clear();
+    turns.clear();
+    current_actions.clear();
+    turn_cursor = 0;
+    action_cursor = 0;
+    replay_us.clear();
+    divergence.reset();
+    aborted.reset();
+}
+
+const std::string &turn_replay::get_world() const
+{
+    return world;
+}
+
+const std::string &turn_replay::get_save_id() const
+{
+    return save_id;
+}
+
+int turn_replay::get_start_turn() const
+{
+    return start_turn;
+}
+
+unsigned int turn_replay::get_seed() const
+{
+    return seed;
+}
+
+const std::vector<turn_replay::turn_entry> &turn_replay::get_turns() const
+{
+    return turns;
+}
+
+uint16_t turn_replay::action_index( const std::string &action )
+{
+    const auto iter = action_ids.find( action );
+    if( iter != action_ids.end() ) {
+        return iter->second;
+    }
+    cata_assert( action_names.size() < std::numeric_limits<uint16_t>::max() );
+    const uint16_t index = static_cast<uint16_t>( action_names.size() );
+    action_names.push_back( action );
+    action_ids.emplace( action, index );
+    return index;
+}
+
+uint32_t turn_replay::rng_check()
+{
+    // Peek at the next output without advancing the game's engine
+    cata_default_random_engine engine = rng_get_engine();
+    return static_cast<uint32_t>( engine() );
+}
+
+// Turns are stored as flat arrays of [rng_check, total_us, action...] to keep
+// long recordings small.
+void turn_replay::serialize( JsonOut &jsout ) const
+{
+    jsout.start_object();
+    jsout.member( "version", replay_version );
+    jsout.member( "world", world );
+    jsout.member( "save", save_id );
+    jsout.member( "start_turn", start_turn );
+    jsout.member( "seed", seed );
+    jsout.member( "actions", action_names );
+    jsout.member( "turns" );
+    jsout.start_array();
+    for( const turn_entry &entry : turns ) {
+        jsout.start_array();
+        jsout.write( entry.rng_check );
+        jsout.write( entry.total_us );
+        for( const uint16_t action : entry.actions ) {
+            jsout.write( action );
+        }
+        jsout.end_array();
+    }
+    jsout.end_array();
+    jsout.end_object();
+}
+
+void turn_replay::deserialize( const JsonObject &jo )
+{
+    clear();
+    if( jo.get_int( "version" ) != replay_version ) {
+        jo.throw_error_at( "version", "unsupported turn replay version" );
+    }
+    world = jo.get_string( "world" );
+    save_id = jo.get_string( "save" );
+    start_turn = jo.get_int( "start_turn" );
+    seed = static_cast<unsigned int>( jo.get_int64( "seed" ) );
+    for( const std::string action : jo.get_array( "actions" ) ) {
+        action_index( action );
+    }
+    for( const JsonArray entry_json : jo.get_array( "turns" ) ) {
+        turn_entry entry;
+        entry.rng_check = static_cast<uint32_t>( entry_json[0].get_uint64() );
+        entry.total_us = entry_json[1].get_uint64();
+        for( size_t i = 2; i < entry_json.size(); ++i ) {
+            const JsonValue action_json = entry_json[i];
+            const int action = action_json.get_int();
+            if( action < 0 || static_cast<size_t>( action ) >= action_names.size() ) {
+                action_json.throw_error( "unknown action index" );
+            }
+            entry.actions.push_back( static_cast<uint16_t>( action ) );
+        }
+        turns.emplace_back( std::move( entry ) );
+    }
+}
+
+turn_replay &get_turn_replay()
+{
+    static turn_replay replay;
+    return replay;
+}
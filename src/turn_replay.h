@@ -0,0 +1,123 @@
+#pragma once
+#ifndef CATA_SRC_TURN_REPLAY_H
+#define CATA_SRC_TURN_REPLAY_H
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class JsonObject;
+class JsonOut;
+
+/**
+ * Records the actions the avatar handles during a stretch of play together with
+ * the RNG state and the profiled duration of every turn, so that the same turns
+ * can later be re-run headlessly from the save made when recording started
+ * (see cata_bench --replay) and their timings compared against the original.
+ *
+ * Only the action ids are recorded: prompts, menus and mouse targets that an
+ * action asks for are not, so a replay involving them is expected to diverge.
+ * A divergence is detected by comparing the RNG state at the end of every turn.
+ */
+class turn_replay
+{
+    public:
+        struct turn_entry {
+            // Next output of the RNG engine once the turn was over.
+            uint32_t rng_check = 0;
+            // Sum of the turn_profiler phases for the turn, in microseconds.
+            uint64_t total_us = 0;
+            // Indices into the action table, in the order they were handled.
+            std::vector<uint16_t> actions;
+        };
+
+        bool is_recording() const;
+        bool is_replaying() const;
+
+        /**
+         * Recording starts at the beginning of the next turn, once the game has been
+         * saved and the RNG reseeded, so that the save is the exact starting point.
+         */
+        void request_recording();
+        /** Stops recording and writes the log to path.  Returns false if nothing was written. */
+        bool stop_recording( const std::string &path );
+
+        /**
+         * Called by do_turn() before the turn counter is advanced.  Returns true if it
+         * must not be: a recording starting with this turn is replayed from a freshly
+         * loaded save, whose first turn does not advance the calendar either.
+         */
+        bool begin_turn();
+        /** Called by do_turn() once the turn is over. */
+        void end_turn( uint64_t total_us );
+        /** Called by game::handle_action() for every action the player entered. */
+        void record_action( const std::string &action );
+
+        /** Reseeds the RNG and starts feeding the loaded log to game::handle_action(). */
+        void start_replay();
+        /** The next recorded action of the current turn, throws if there is none. */
+        std::string next_action();
+        /** True once every recorded turn has been replayed. */
+        bool replay_finished() const;
+        /** Number of turns replayed so far. */
+        size_t replayed_turns() const;
+        /** Profiled duration of a replayed turn, in microseconds. */
+        uint64_t replayed_us( size_t turn ) const;
+        /** First replayed turn whose RNG state or actions did not match the log. */
+        std::optional<size_t> first_divergence() const;
+        /**
+         * Stops a replay interrupted by an exception thrown from do_turn(), so no further
+         * actions are fed to the game.  The interrupted turn is not counted as replayed.
+         */
+        void abort_replay();
+        /** Turn the replay was aborted in, relative to the start of the recording. */
+        std::optional<size_t> aborted_turn() const;
+
+        void clear();
+
+        const std::string &get_world() const;
+        const std::string &get_save_id() const;
+        int get_start_turn() const;
+        unsigned int get_seed() const;
+        const std::vector<turn_entry> &get_turns() const;
+
+        void serialize( JsonOut &jsout ) const;
+        void deserialize( const JsonObject &jo );
+
+    private:
+        enum class replay_mode : int {
+            off,
+            pending,
+            recording,
+            replaying
+        };
+
+        uint16_t action_index( const std::string &action );
+        static uint32_t rng_check();
+
+        replay_mode mode = replay_mode::off;
+        std::string world;
+        std::string save_id;
+        int start_turn = 0;
+        unsigned int seed = 0;
+        std::vector<std::string> action_names;
+        std::unordered_map<std::string, uint16_t> action_ids;
+        std::vector<turn_entry> turns;
+        // Actions recorded since the current turn started.
+        std::vector<uint16_t> current_actions;
+
+        // Replay state
+        size_t turn_cursor = 0;
+        size_t action_cursor = 0;
+        std::vector<uint64_t> replay_us;
+        std::optional<size_t> divergence;
+        std::optional<size_t> aborted;
+};
+
+turn_replay &get_turn_replay();
+
+#endif // CATA_SRC_TURN_REPLAY_H
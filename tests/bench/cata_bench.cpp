@@ -0,0 +1,486 @@
+// Headless turn throughput benchmark.
+//
+// Loads a saved world, or builds one of the reference scenarios in a fresh
+// world, then runs the main do_turn() loop for a fixed number of turns with a
+// fixed RNG seed while the avatar waits in place.  Reports turns per second,
+// per-phase timings from the turn_profiler and the peak resident set size.
+//
+// With --replay, instead re-runs the turns recorded in a turn_replay log from
+// the save made when recording started, feeding the recorded actions back to
+// the avatar, and compares the time every turn took against the recording.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "avatar.h"
+#include "cached_options.h"
+#include "calendar.h"
+#include "cata_path.h"
+#include "cata_utility.h"
+#include "cata_allocator.h"
+#include "compatibility.h"
+#include "coordinates.h"
+#include "creature_tracker.h"
+#include "debug.h"
+#include "do_turn.h"
+#include "enum_conversions.h"
+#include "filesystem.h"
+#include "flexbuffer_json.h"
+#include "game.h"
+#include "json.h"
+#include "map.h"
+#include "map_scale_constants.h"
+#include "npc.h"
+#include "perf.h"
+#include "point.h"
+#include "rng.h"
+#include "test_init.h"
+#include "turn_replay.h"
+#include "type_id.h"
+#include "units.h"
+#include "vehicle.h"
+#include "worldfactory.h"
+
+static const mtype_id mon_zombie( "mon_zombie" );
+static const mtype_id mon_zombie_fast( "mon_zombie_fast" );
+static const mtype_id mon_zombie_tough( "mon_zombie_tough" );
+
+static const ter_str_id ter_t_wall( "t_wall" );
+
+static const trait_id trait_DEBUG_NODMG( "DEBUG_NODMG" );
+
+static const vproto_id vehicle_prototype_pickup( "pickup" );
+
+namespace
+{
+
+struct bench_options {
+    std::string world;
+    std::string scenario = "dense_city";
+    std::string mods;
+    std::string user_dir = "./bench_user_dir/";
+    std::string csv_path;
+    std::string json_path;
+    std::string replay_path;
+    int turns = 1000;
+    unsigned int seed = 42;
+    bool help = false;
+};
+
+// A reference situation built in a fresh world, with an optional hook run
+// before every turn to keep the situation going.
+struct bench_scenario {
+    std::function<void()> setup;
+    std::function<void()> per_turn;
+};
+
+tripoint_bub_ms random_free_spot( map &here, int radius )
+{
+    const tripoint_bub_ms center = get_avatar().pos_bub();
+    creature_tracker &creatures = get_creature_tracker();
+    for( int attempt = 0; attempt < 1000; ++attempt ) {
+        const tripoint_bub_ms p = center + tripoint_rel_ms( rng( -radius, radius ), rng( -radius, radius ),
+                                  0 );
+        if( here.inbounds( p ) && here.passable( p ) && creatures.creature_at( p ) == nullptr ) {
+            return p;
+        }
+    }
+    return center;
+}
+
+// A few hundred zombies converging on the avatar from across the bubble
+void setup_dense_city()
+{
+    map &here = get_map();
+    const std::vector<mtype_id> types = { mon_zombie, mon_zombie, mon_zombie_fast, mon_zombie_tough };
+    for( int i = 0; i < 300; ++i ) {
+        g->place_critter_at( random_entry( types ), random_free_spot( here, 50 ) );
+    }
+}
+
+// Zombies finding their way to the avatar through rings of walls with one gap each, so
+// that they need the pathfinder rather than straight lines
+void setup_maze()
+{
+    map &here = get_map();
+    const tripoint_bub_ms center = get_avatar().pos_bub();
+    for( int radius = 8; radius <= 40; radius += 8 ) {
+        // The gaps alternate between the north and south sides
+        const point_rel_ms gap( 0, radius % 16 == 0 ? -radius : radius );
+        for( int i = -radius; i <= radius; ++i ) {
+            for( const point_rel_ms &p : {
+                     point_rel_ms( i, -radius ), point_rel_ms( i, radius ),
+                     point_rel_ms( -radius, i ), point_rel_ms( radius, i )
+                 } ) {
+                if( p != gap ) {
+                    here.ter_set( center + p, ter_t_wall );
+                }
+            }
+        }
+    }
+    const std::vector<mtype_id> types = { mon_zombie, mon_zombie_fast };
+    for( int placed = 0, attempt = 0; placed < 200 && attempt < 10000; ++attempt ) {
+        const tripoint_bub_ms p = random_free_spot( here, 55 );
+        if( square_dist( p, center ) > 40 ) {
+            g->place_critter_at( random_entry( types ), p );
+            ++placed;
+        }
+    }
+}
+
+// Dozens of NPCs going about their business around the avatar
+void setup_basecamp()
+{
+    map &here = get_map();
+    for( int i = 0; i < 40; ++i ) {
+        here.place_npc( random_free_spot( here, 20 ).xy(), npc_template_id( "test_talker" ) );
+    }
+    g->load_npcs();
+}
+
+// Running vehicles circling around the avatar, as if driven
+void setup_convoy()
+{
+    map &here = get_map();
+    const tripoint_bub_ms center = get_avatar().pos_bub();
+    for( int i = 0; i < 8; ++i ) {
+        const tripoint_bub_ms p = center + tripoint_rel_ms( -40 + i * 10, 15, 0 );
+        vehicle *veh = here.add_vehicle( vehicle_prototype_pickup, p, 0_degrees, 100, 0 );
+        if( veh == nullptr ) {
+            continue;
+        }
+        veh->engine_on = true;
+        veh->cruise_velocity = 1000;
+    }
+}
+
+void convoy_per_turn()
+{
+    map &here = get_map();
+    for( const wrapped_vehicle &wv : here.get_vehicles() ) {
+        vehicle &veh = *wv.v;
+        if( !veh.engine_on ) {
+            continue;
+        }
+        veh.thrust( here, 1 );
+        veh.turn( 15_degrees );
+    }
+}
+
+const std::map<std::string, bench_scenario> &scenarios()
+{
+    static const std::map<std::string, bench_scenario> ret = {
+        { "dense_city", { setup_dense_city, nullptr } },
+        { "basecamp", { setup_basecamp, nullptr } },
+        { "convoy", { setup_convoy, convoy_per_turn } },
+        { "maze", { setup_maze, nullptr } },
+    };
+    return ret;
+}
+
+// In kibibytes, or 0 if unavailable
+long peak_rss_kib()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ) {
+        return static_cast<long>( counters.PeakWorkingSetSize / 1024 );
+    }
+    return 0;
+#else
+    rusage usage;
+    if( getrusage( RUSAGE_SELF, &usage ) != 0 ) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    // Bytes on macOS, kibibytes elsewhere
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+void print_usage()
+{
+    std::printf( "Usage: cata_bench [options]\n"
+                 "  --world NAME       benchmark the first save of world NAME in the user dir\n"
+                 "  --scenario NAME    otherwise build a reference scenario in a fresh world:\n"
+                 "                     dense_city (default), basecamp, convoy, maze\n"
+                 "  --turns N          number of turns to simulate (default 1000)\n"
+                 "  --seed N           RNG seed (default 42)\n"
+                 "  --mods a,b         extra mods for scenario worlds\n"
+                 "  --user-dir DIR     user dir holding config and saves (default ./bench_user_dir/)\n"
+                 "  --csv FILE         write per-turn phase timings as CSV\n"
+                 "  --json FILE        write phase statistics and per-turn timings as JSON\n"
+                 "  --replay FILE      replay a turn_replay.json recorded in game from the save\n"
+                 "                     it was started from, and compare per-turn timings\n" );
+}
+
+bool parse_args( int argc, const char *argv[], bench_options &opts )
+{
+    for( int i = 1; i < argc; ++i ) {
+        const std::string arg = argv[i];
+        if( arg == "--help" || arg == "-h" ) {
+            opts.help = true;
+            return true;
+        }
+        if( i + 1 >= argc ) {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if( arg == "--world" ) {
+            opts.world = value;
+        } else if( arg == "--scenario" ) {
+            opts.scenario = value;
+        } else if( arg == "--turns" ) {
+            opts.turns = std::atoi( value.c_str() );
+        } else if( arg == "--seed" ) {
+            opts.seed = static_cast<unsigned int>( std::strtoul( value.c_str(), nullptr, 10 ) );
+        } else if( arg == "--mods" ) {
+            opts.mods = value;
+        } else if( arg == "--user-dir" ) {
+            opts.user_dir = value;
+        } else if( arg == "--csv" ) {
+            opts.csv_path = value;
+        } else if( arg == "--json" ) {
+            opts.json_path = value;
+        } else if( arg == "--replay" ) {
+            opts.replay_path = value;
+        } else {
+            return false;
+        }
+    }
+    if( !opts.user_dir.empty() && opts.user_dir.back() != '/' ) {
+        opts.user_dir += '/';
+    }
+    return opts.turns > 0 && ( !opts.replay_path.empty() || !opts.world.empty() ||
+                               scenarios().count( opts.scenario ) );
+}
+
+// Loads the save a replay was recorded from, returns false on mismatch
+bool load_replay( const bench_options &opts )
+{
+    turn_replay &replay = get_turn_replay();
+    const cata_path path( cata_path::root_path::unknown, opts.replay_path );
+    const bool read = read_from_file_json( path, [&replay]( const JsonValue & jv ) {
+        replay.deserialize( jv );
+    } );
+    if( !read ) {
+        return false;
+    }
+    if( !g->load( replay.get_world() ) ) {
+        std::fprintf( stderr, "Failed to load world %s\n", replay.get_world().c_str() );
+        return false;
+    }
+    if( get_avatar().get_save_id() != replay.get_save_id() ) {
+        std::fprintf( stderr, "World %s has save %s loaded instead of %s\n", replay.get_world().c_str(),
+                      get_avatar().get_save_id().c_str(), replay.get_save_id().c_str() );
+        return false;
+    }
+    if( to_turns<int>( calendar::turn - calendar::turn_zero ) != replay.get_start_turn() ) {
+        std::fprintf( stderr, "The save is at turn %d but the replay starts at turn %d; "
+                      "it was saved again after recording\n",
+                      to_turns<int>( calendar::turn - calendar::turn_zero ), replay.get_start_turn() );
+        return false;
+    }
+    return true;
+}
+
+void print_replay_report()
+{
+    const turn_replay &replay = get_turn_replay();
+    const std::vector<turn_replay::turn_entry> &turns = replay.get_turns();
+    const size_t replayed = replay.replayed_turns();
+    uint64_t recorded_total = 0;
+    uint64_t replayed_total = 0;
+    // Turns sorted by how much slower they were than in the recording
+    std::vector<std::pair<int64_t, size_t>> slowdowns;
+    for( size_t i = 0; i < replayed; ++i ) {
+        recorded_total += turns[i].total_us;
+        replayed_total += replay.replayed_us( i );
+        slowdowns.emplace_back( static_cast<int64_t>( replay.replayed_us( i ) ) -
+                                static_cast<int64_t>( turns[i].total_us ), i );
+    }
+    std::sort( slowdowns.rbegin(), slowdowns.rend() );
+
+    std::printf( "replay: %zu of %zu turns, recorded %.1f ms, replayed %.1f ms (%+.1f%%)\n",
+                 replayed, turns.size(), recorded_total / 1000.0, replayed_total / 1000.0,
+                 recorded_total > 0 ? 100.0 * ( static_cast<double>( replayed_total ) - recorded_total ) /
+                 recorded_total : 0.0 );
+    if( replay.first_divergence() ) {
+        std::printf( "replay diverged from the recording at turn %d, timings after it are not comparable\n",
+                     replay.get_start_turn() + static_cast<int>( *replay.first_divergence() ) );
+    }
+    std::printf( "%-10s %12s %12s\n", "turn", "recorded us", "replayed us" );
+    for( size_t i = 0; i < std::min<size_t>( slowdowns.size(), 10 ); ++i ) {
+        const size_t turn = slowdowns[i].second;
+        std::printf( "%-10d %12llu %12llu\n", replay.get_start_turn() + static_cast<int>( turn ),
+                     static_cast<unsigned long long>( turns[turn].total_us ),
+                     static_cast<unsigned long long>( replay.replayed_us( turn ) ) );
+    }
+}
+
+void print_report( const bench_options &opts, int turns_done, double seconds )
+{
+    const turn_profiler &profiler = get_turn_profiler();
+    std::printf( "%s: %d turns in %.2f s, %.1f turns/s, peak RSS %ld MiB\n",
+                 opts.world.empty() ? opts.scenario.c_str() : opts.world.c_str(), turns_done, seconds,
+                 seconds > 0 ? turns_done / seconds : 0.0, peak_rss_kib() / 1024 );
+    std::printf( "%-16s %10s %10s %10s\n", "phase (us)", "p50", "p99", "max" );
+    const auto row = []( const std::string & name, const turn_profiler::phase_stats & stats ) {
+        std::printf( "%-16s %10llu %10llu %10llu\n", name.c_str(),
+                     static_cast<unsigned long long>( stats.p50 ),
+                     static_cast<unsigned long long>( stats.p99 ),
+                     static_cast<unsigned long long>( stats.max ) );
+    };
+    for( size_t i = 0; i < turn_profiler::num_phases; ++i ) {
+        const turn_phase phase = static_cast<turn_phase>( i );
+        row( io::enum_to_string( phase ), profiler.get_stats( phase ) );
+    }
+    row( "total", profiler.get_total_stats() );
+
+    if( !opts.csv_path.empty() ) {
+        write_to_file( opts.csv_path, [&]( std::ostream & out ) {
+            profiler.write_csv( out );
+        }, "turn profile" );
+    }
+    if( !opts.json_path.empty() ) {
+        write_to_file( opts.json_path, [&]( std::ostream & out ) {
+            JsonOut jsout( out, true );
+            jsout.start_object();
+            jsout.member( "name", opts.world.empty() ? opts.scenario : opts.world );
+            jsout.member( "seed", opts.seed );
+            jsout.member( "turns_per_second", seconds > 0 ? turns_done / seconds : 0.0 );
+            jsout.member( "peak_rss_kib", peak_rss_kib() );
+            jsout.member( "profile", profiler );
+            jsout.end_object();
+        }, "turn profile" );
+    }
+}
+
+} // namespace
+
+int main( int argc, const char *argv[] )
+{
+    cata::init_allocator();
+    reset_floating_point_mode();
+
+    bench_options opts;
+    if( !parse_args( argc, argv, opts ) ) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+    if( opts.help ) {
+        print_usage();
+        return EXIT_SUCCESS;
+    }
+
+    test_mode = true;
+    setupDebug( DebugOutput::std_err );
+    rng_set_engine_seed( opts.seed );
+
+    // Nothing is ever drawn, and the benchmarked save must not be modified.
+    const option_overrides_t overrides = {
+        { "FORCE_REDRAW", "false" },
+        { "AUTOSAVE", "false" },
+    };
+    try {
+        init_test_game( overrides, opts.user_dir );
+        if( !opts.replay_path.empty() ) {
+            if( !load_replay( opts ) ) {
+                return EXIT_FAILURE;
+            }
+            opts.world = get_turn_replay().get_world();
+        } else if( !opts.world.empty() ) {
+            if( !g->load( opts.world ) ) {
+                std::fprintf( stderr, "Failed to load world %s\n", opts.world.c_str() );
+                return EXIT_FAILURE;
+            }
+        } else {
+            init_test_world( extract_mod_selection( opts.mods ) );
+            scenarios().at( opts.scenario ).setup();
+        }
+    } catch( const std::exception &err ) {
+        std::fprintf( stderr, "Initialization failed: %s\n", err.what() );
+        return EXIT_FAILURE;
+    }
+
+    avatar &u = get_avatar();
+    if( !opts.replay_path.empty() ) {
+        turn_replay &replay = get_turn_replay();
+        get_turn_profiler().clear();
+        replay.start_replay();
+        int turns_done = 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        try {
+            for( ; !replay.replay_finished(); ++turns_done ) {
+                if( do_turn() ) {
+                    break;
+                }
+            }
+        } catch( const std::exception &err ) {
+            // The interrupted turn never finished, leave it out of the report
+            replay.abort_replay();
+            get_turn_profiler().discard_turn();
+            std::fprintf( stderr, "Replay failed in turn %d: %s\n",
+                          replay.get_start_turn() + static_cast<int>( *replay.aborted_turn() ), err.what() );
+        }
+        const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() -
+                               start ).count();
+        print_report( opts, turns_done, seconds );
+        print_replay_report();
+        return replay.aborted_turn() ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    // Keep the avatar alive so every run simulates the full number of turns
+    u.set_mutation( trait_DEBUG_NODMG );
+    std::function<void()> per_turn;
+    if( opts.world.empty() ) {
+        per_turn = scenarios().at( opts.scenario ).per_turn;
+    }
+
+    // Reseed so the simulated turns don't depend on how much randomness the setup consumed
+    rng_set_engine_seed( opts.seed );
+    get_turn_profiler().clear();
+    int turns_done = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for( ; turns_done < opts.turns; ++turns_done ) {
+        // The avatar waits: with no moves left do_turn() never asks for input.
+        u.set_moves( 0 );
+        g->cleanup_dead();
+        if( per_turn ) {
+            per_turn();
+        }
+        if( do_turn() ) {
+            break;
+        }
+    }
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() -
+                           start ).count();
+
+    print_report( opts, turns_done, seconds );
+
+    if( opts.world.empty() && world_generator->active_world ) {
+        world_generator->delete_world( world_generator->active_world->world_name, true );
+    }
+    return EXIT_SUCCESS;
+}
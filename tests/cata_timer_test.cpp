@@ -0,0 +1,97 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cata_catch.h"
+#include "perf.h"
+
+TEST_CASE( "cata_timer_scope_ids_are_shared_by_name", "[perf][nogame]" )
+{
+    const cata_perf::scope_id id = cata_perf::register_scope( "cata_timer_test_id" );
+    CHECK( cata_perf::register_scope( "cata_timer_test_id" ) == id );
+    CHECK( cata_perf::register_scope( "cata_timer_test_other_id" ) != id );
+    CHECK( cata_perf::scope_name( id ) == "cata_timer_test_id" );
+}
+
+TEST_CASE( "cata_timer_nests_scopes", "[perf][nogame]" )
+{
+    cata_timer::reset_stats();
+    for( int i = 0; i < 3; ++i ) {
+        CATA_TIMER_SCOPE( "cata_timer_test_outer" );
+        for( int j = 0; j < 2; ++j ) {
+            CATA_TIMER_SCOPE( "cata_timer_test_inner" );
+        }
+    }
+    {
+        cata_timer dynamic_name( std::string( "cata_timer_test_" ) + "outer" );
+    }
+
+    const cata_timer::timers_map stats = cata_timer::get_stats();
+    CHECK( stats.count( "cata_timer_test_inner" ) == 0 );
+    const auto outer = stats.find( "cata_timer_test_outer" );
+    REQUIRE( outer != stats.end() );
+    CHECK( outer->second.count == 4 );
+    const auto inner = outer->second.child_timers.find( "cata_timer_test_inner" );
+    REQUIRE( inner != outer->second.child_timers.end() );
+    CHECK( inner->second.count == 6 );
+    CHECK( inner->second.duration <= outer->second.duration );
+}
+
+TEST_CASE( "cata_timer_merges_threads", "[perf][nogame]" )
+{
+    cata_timer::reset_stats();
+    std::vector<std::thread> threads;
+    for( int i = 0; i < 4; ++i ) {
+        threads.emplace_back( []() {
+            for( int j = 0; j < 100; ++j ) {
+                CATA_TIMER_SCOPE( "cata_timer_test_thread" );
+            }
+        } );
+    }
+    for( std::thread &t : threads ) {
+        t.join();
+    }
+    {
+        CATA_TIMER_SCOPE( "cata_timer_test_thread" );
+    }
+
+    const cata_timer::timers_map stats = cata_timer::get_stats();
+    const auto it = stats.find( "cata_timer_test_thread" );
+    REQUIRE( it != stats.end() );
+    CHECK( it->second.count == 401 );
+}
+
+TEST_CASE( "cata_timer_reset_while_threads_record", "[perf][nogame]" )
+{
+    constexpr int iterations = 10000;
+    std::thread recorder( []() {
+        for( int j = 0; j < iterations; ++j ) {
+            CATA_TIMER_SCOPE( "cata_timer_test_reset" );
+        }
+    } );
+    for( int i = 0; i < 100; ++i ) {
+        cata_timer::reset_stats();
+    }
+    recorder.join();
+    const cata_timer::timers_map during = cata_timer::get_stats();
+    const auto it = during.find( "cata_timer_test_reset" );
+    if( it != during.end() ) {
+        CHECK( it->second.count <= static_cast<uint64_t>( iterations ) );
+    }
+
+    cata_timer::reset_stats();
+    CHECK( cata_timer::get_stats().count( "cata_timer_test_reset" ) == 0 );
+    for( int j = 0; j < 3; ++j ) {
+        CATA_TIMER_SCOPE( "cata_timer_test_reset" );
+    }
+    const cata_timer::timers_map after = cata_timer::get_stats();
+    REQUIRE( after.count( "cata_timer_test_reset" ) == 1 );
+    CHECK( after.at( "cata_timer_test_reset" ).count == 3 );
+}
+
+TEST_CASE( "cata_timer_benchmark", "[.][perf][benchmark][nogame]" )
+{
+    BENCHMARK( "CATA_TIMER_SCOPE" ) {
+        CATA_TIMER_SCOPE( "cata_timer_test_benchmark" );
+    };
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <vector>
+
+#include "cata_catch.h"
+#include "coordinates.h"
+#include "creature_tracker.h"
+#include "game.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "monster.h"
+#include "point.h"
+
+// Brute force version of creature_tracker::monsters_in_radius
+static std::vector<monster *> monsters_near( const tripoint_abs_ms &center, int radius )
+{
+    std::vector<monster *> result;
+    for( monster &critter : g->all_monsters() ) {
+        const tripoint_rel_ms d = critter.pos_abs() - center;
+        if( std::abs( d.x() ) <= radius && std::abs( d.y() ) <= radius && std::abs( d.z() ) <= radius ) {
+            result.push_back( &critter );
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+static std::vector<monster *> indexed_monsters_near( const tripoint_abs_ms &center, int radius )
+{
+    std::vector<monster *> result = get_creature_tracker().monsters_in_radius( center, radius );
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+TEST_CASE( "creature_tracker_spatial_queries_match_brute_force", "[creature_tracker]" )
+{
+    clear_map();
+    map &here = get_map();
+    const tripoint_bub_ms origin( 50, 50, 0 );
+    for( int i = 0; i < 12; ++i ) {
+        spawn_test_monster( "mon_zombie", origin + tripoint_rel_ms( i * 7 - 40, i * 4 - 23, 0 ) );
+    }
+    spawn_test_monster( "mon_zombie", origin );
+    const tripoint_abs_ms center = here.get_abs( origin );
+
+    for( const int radius : { 0, 1, 7, 12, 25, 60 } ) {
+        CAPTURE( radius );
+        CHECK( indexed_monsters_near( center, radius ) == monsters_near( center, radius ) );
+    }
+
+    SECTION( "moved monsters are found at their new position" ) {
+        monster &critter = *get_creature_tracker().creature_at<monster>( origin + tripoint_rel_ms( 23,
+                           13, 0 ) );
+        critter.setpos( here, origin + tripoint_rel_ms( -40, 40, 0 ) );
+        CHECK( indexed_monsters_near( center, 30 ) == monsters_near( center, 30 ) );
+        CHECK( indexed_monsters_near( center, 40 ) == monsters_near( center, 40 ) );
+    }
+
+    SECTION( "swapped monsters are found at their new positions" ) {
+        creature_tracker &tracker = get_creature_tracker();
+        monster &first = *tracker.creature_at<monster>( origin + tripoint_rel_ms( -40, -23, 0 ) );
+        monster &second = *tracker.creature_at<monster>( origin );
+        tracker.swap_positions( first, second );
+        CHECK( indexed_monsters_near( center, 1 ) == std::vector<monster *> { &first } );
+        CHECK( indexed_monsters_near( center, 35 ) == monsters_near( center, 35 ) );
+    }
+
+    SECTION( "dead and removed monsters are not returned" ) {
+        monster &critter = *get_creature_tracker().creature_at<monster>( origin );
+        critter.die( &here, nullptr );
+        CHECK( indexed_monsters_near( center, 1 ).empty() );
+        g->cleanup_dead();
+        CHECK( indexed_monsters_near( center, 60 ) == monsters_near( center, 60 ) );
+    }
+
+    clear_creatures();
+    CHECK( get_creature_tracker().monsters_in_radius( center, 60 ).empty() );
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -7,6 +8,7 @@
 #include "cata_catch.h"
 #include "character.h"
 #include "coordinates.h"
+#include "effect_source.h"
 #include "field.h"
 #include "field_type.h"
 #include "item.h"
@@ -17,6 +19,7 @@
 #include "options_helpers.h"
 #include "player_helpers.h"
 #include "point.h"
+#include "rng.h"
 #include "string_formatter.h"
 #include "type_id.h"
 #include "weather_type.h"
@@ -24,8 +27,12 @@
 static const efftype_id effect_test_rash( "test_rash" );
 
 static const field_type_str_id field_fd_acid( "fd_acid" );
+static const field_type_str_id field_fd_cigsmoke( "fd_cigsmoke" );
+static const field_type_str_id field_fd_fog( "fd_fog" );
 static const field_type_str_id field_fd_test( "fd_test" );
 
+static const furn_str_id furn_f_fog( "f_fog" );
+
 static const itype_id itype_test_2x4( "test_2x4" );
 static const itype_id itype_test_hazmat_hat( "test_hazmat_hat" );
 static const itype_id itype_test_hazmat_shirt( "test_hazmat_shirt" );
@@ -68,6 +75,134 @@ TEST_CASE( "acid_field_expiry_on_map", "[field]" )
     CHECK( count_fields( field_fd_acid ) == Approx( 8712 ).margin( 300 ) );
 }
 
+static bool field_expires( const tripoint_bub_ms &p, const field_type_str_id &field_type )
+{
+    map &m = get_map();
+    const time_point before_time = calendar::turn;
+    while( calendar::turn - before_time < field_type.obj().half_life * 20 ) {
+        m.process_fields();
+        calendar::turn += 1_seconds;
+        if( !m.get_field( p, field_type ) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int gas_intensity_around( const tripoint_bub_ms &p, int radius,
+                                 const field_type_str_id &field_type )
+{
+    map &m = get_map();
+    int total = 0;
+    for( const tripoint_bub_ms &cursor : points_in_radius( p, radius, 1 ) ) {
+        total += m.get_field_intensity( cursor, field_type );
+    }
+    return total;
+}
+
+TEST_CASE( "gas_spreads_at_most_one_square_per_pass", "[field]" )
+{
+    clear_map_without_vision( -1, 1 );
+    map &m = get_map();
+    const tripoint_bub_ms p{ 33, 33, 0 };
+
+    for( int i = 0; i < 20; ++i ) {
+        for( int z = -1; z <= 1; ++z ) {
+            clear_fields( z );
+        }
+        // Thick enough to spread, and it tries to on every pass
+        m.add_field( p, field_fd_cigsmoke, 3 );
+        m.process_fields();
+
+        CAPTURE( i );
+        const int nearby = gas_intensity_around( p, 1, field_fd_cigsmoke );
+        CHECK( nearby <= 3 );
+        CHECK( gas_intensity_around( p, 2, field_fd_cigsmoke ) == nearby );
+    }
+}
+
+TEST_CASE( "gas_spread_is_repeatable", "[field]" )
+{
+    clear_map_without_vision( -1, 1 );
+    map &m = get_map();
+    const tripoint_bub_ms p{ 33, 33, 0 };
+
+    // Spreads over several submaps, so the moves are picked by several tasks
+    const auto spread_smoke = [&]() {
+        for( int z = -1; z <= 1; ++z ) {
+            clear_fields( z );
+        }
+        m.add_field( p, field_fd_cigsmoke, 3 );
+        m.add_field( p + point( 12, 0 ), field_fd_cigsmoke, 3 );
+        m.add_field( p + point( 0, 12 ), field_fd_cigsmoke, 3 );
+        rng_set_engine_seed( 1234 );
+        // Few enough passes that the smoke has not all aged away outdoors
+        for( int i = 0; i < 3; ++i ) {
+            m.process_fields();
+        }
+        std::vector<int> intensities;
+        for( const tripoint_bub_ms &cursor : points_in_radius( p + point( 6, 6 ), 20, 1 ) ) {
+            intensities.push_back( m.get_field_intensity( cursor, field_fd_cigsmoke ) );
+        }
+        return intensities;
+    };
+    const std::vector<int> first = spread_smoke();
+    CHECK( std::count_if( first.begin(), first.end(), []( int intensity ) {
+        return intensity > 0;
+    } ) > 3 );
+    CHECK( spread_smoke() == first );
+}
+
+TEST_CASE( "fields_are_processed_after_their_square_was_cleared", "[field]" )
+{
+    clear_map_without_vision();
+    map &m = get_map();
+    const tripoint_bub_ms p{ 33, 33, 0 };
+    const tripoint_bub_ms far_away{ 90, 90, 0 };
+
+    m.add_field( p, field_fd_acid, 1 );
+    REQUIRE( field_expires( p, field_fd_acid ) );
+
+    // The square of the first field was skipped since it went away, so both the new fields
+    // must mark their squares again.
+    m.add_field( p, field_fd_acid, 1 );
+    m.add_field( far_away, field_fd_acid, 1 );
+    CHECK( field_expires( p, field_fd_acid ) );
+    CHECK( field_expires( far_away, field_fd_acid ) );
+    CHECK( count_fields( field_fd_acid ) == 0 );
+}
+
+TEST_CASE( "field_emitters_emit_once_per_period_on_staggered_turns", "[field]" )
+{
+    clear_map_without_vision();
+    map &m = get_map();
+    const tripoint_bub_ms p{ 33, 33, 0 };
+    const tripoint_bub_ms q{ 54, 33, 0 };
+    m.furn_set( p, furn_f_fog );
+    m.furn_set( q, furn_f_fog );
+
+    int p_emitted_on = -1;
+    int q_emitted_on = -1;
+    int emissions = 0;
+    for( int turn = 0; turn < map::emitter_period; ++turn ) {
+        clear_fields( 0 );
+        m.emit_fields_due();
+        if( m.get_field( p, field_fd_fog ) ) {
+            p_emitted_on = turn;
+            emissions++;
+        }
+        if( m.get_field( q, field_fd_fog ) ) {
+            q_emitted_on = turn;
+            emissions++;
+        }
+        calendar::turn += 1_seconds;
+    }
+    CHECK( emissions == 2 );
+    CHECK( p_emitted_on >= 0 );
+    CHECK( q_emitted_on >= 0 );
+    CHECK( p_emitted_on != q_emitted_on );
+}
+
 static void test_field_expiry( const std::string &field_type_str )
 {
     const field_type_str_id field_type( field_type_str );
@@ -487,6 +622,39 @@ TEST_CASE( "field_API_test", "[field]" )
     fields_test_cleanup();
 }
 
+TEST_CASE( "field_storage_is_only_allocated_for_fields", "[field]" )
+{
+    field f;
+    CHECK( f.field_count() == 0 );
+    CHECK( f.begin() == f.end() );
+    CHECK_FALSE( f.find_field( fd_fire, /*alive_only*/ false ) );
+    CHECK_FALSE( f.remove_field( fd_fire ) );
+
+    CHECK( f.add_field( fd_fire, 1 ) );
+    CHECK( f.field_count() == 1 );
+    CHECK( f.begin() != f.end() );
+
+    const field copy = f;
+    f.clear();
+    CHECK( f.field_count() == 0 );
+    CHECK( f.begin() == f.end() );
+    CHECK( copy.find_field( fd_fire ) );
+}
+
+TEST_CASE( "field_entry_keeps_its_source", "[field]" )
+{
+    avatar &u = get_avatar();
+    const field_entry no_source( fd_fire, 1, 0_turns );
+    CHECK( no_source.get_causer() == nullptr );
+    CHECK_FALSE( no_source.get_effect_source().get_character_id() );
+
+    const field_entry with_source( fd_fire, 1, 0_turns, effect_source( &u ) );
+    const field_entry copy = with_source;
+    CHECK( with_source.get_causer() == &u );
+    CHECK( copy.get_causer() == &u );
+    CHECK( copy.get_effect_source().get_character_id() == u.getID() );
+}
+
 TEST_CASE( "player_double_effect_field_test", "[field][player]" )
 {
     fields_test_setup();
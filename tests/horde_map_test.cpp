@@ -1,5 +1,9 @@
 #include "horde_map.h"
 
+#include <cstdint>
+#include <limits>
+#include <optional>
+
 #include "cata_catch.h"
 #include "coordinates.h"
 #include "monster.h"
@@ -24,14 +28,14 @@ static tripoint_om_ms pick_available_location( horde_map &test_horde )
     tripoint_om_ms candidate;
     do {
         candidate = random_location();
-    } while( test_horde.entity_at( candidate ) != nullptr );
+    } while( test_horde.entity_at( candidate ) );
     return candidate;
 }
 
 static int count_entities( horde_map &test_horde, int filter )
 {
     int entity_count = 0;
-    for( [[maybe_unused]]std::pair<const tripoint_abs_ms, horde_entity> &entity : test_horde.get_view(
+    for( [[maybe_unused]]horde_entity_ref entity : test_horde.get_view(
              filter ) ) {
         entity_count++;
     }
@@ -43,7 +47,7 @@ static void place_entity( horde_map &test_horde, mtype_id id )
     tripoint_om_ms monster_relative = pick_available_location( test_horde );
     tripoint_abs_ms monster_location( project_combine( test_horde.get_location(), monster_relative ) );
     test_horde.spawn_entity( monster_location, id );
-    REQUIRE( test_horde.entity_at( monster_relative ) != nullptr );
+    REQUIRE( test_horde.entity_at( monster_relative ) );
 }
 
 static void place_monster_as_entity( horde_map &test_horde, monster &mon )
@@ -51,7 +55,7 @@ static void place_monster_as_entity( horde_map &test_horde, monster &mon )
     tripoint_om_ms monster_relative = pick_available_location( test_horde );
     tripoint_abs_ms monster_location( project_combine( test_horde.get_location(), monster_relative ) );
     test_horde.spawn_entity( monster_location, mon );
-    REQUIRE( test_horde.entity_at( monster_relative ) != nullptr );
+    REQUIRE( test_horde.entity_at( monster_relative ) );
 }
 
 /*
@@ -82,7 +86,7 @@ TEST_CASE( "horde_map_insertion_and_retrieval", "[hordes]" )
     place_entity( test_horde, mon_pseudo_dormant_zombie );
 
     int entity_count = 0;
-    for( [[maybe_unused]]std::pair<const tripoint_abs_ms, horde_entity> &entity : test_horde ) {
+    for( [[maybe_unused]]horde_entity_ref entity : test_horde ) {
         entity_count++;
     }
     CHECK( entity_count == 6 );
@@ -95,20 +99,22 @@ TEST_CASE( "horde_map_insertion_and_retrieval", "[hordes]" )
 
     // Remove an idle and a dormant entity, give them a goal, and re-insert them.
     // TODO: This stays dormant! Need to add support for them changing.
-    horde_map::node_type dormant_node = test_horde.extract( test_horde.get_view(
-                                            horde_map_flavors::dormant ).begin() );
-    dormant_node.mapped().tracking_intensity = 100;
-    dormant_node.mapped().destination = random_abs_location( test_horde );;
-    test_horde.insert( std::move( dormant_node ) );
-
-    horde_map::node_type idle_node = test_horde.extract( test_horde.get_view(
-                                         horde_map_flavors::idle ).begin() );
-    idle_node.mapped().tracking_intensity = 100;
-    idle_node.mapped().destination = random_abs_location( test_horde );;
-    test_horde.insert( std::move( idle_node ) );
+    horde_map::iterator dormant_iter = test_horde.get_view( horde_map_flavors::dormant ).begin();
+    const tripoint_abs_ms dormant_pos = dormant_iter->pos();
+    horde_entity dormant_entity = test_horde.extract( dormant_iter );
+    dormant_entity.tracking_intensity = 100;
+    dormant_entity.destination = random_abs_location( test_horde );
+    test_horde.insert( dormant_pos, std::move( dormant_entity ) );
+
+    horde_map::iterator idle_iter = test_horde.get_view( horde_map_flavors::idle ).begin();
+    const tripoint_abs_ms idle_pos = idle_iter->pos();
+    horde_entity idle_entity = test_horde.extract( idle_iter );
+    idle_entity.tracking_intensity = 100;
+    idle_entity.destination = random_abs_location( test_horde );
+    test_horde.insert( idle_pos, std::move( idle_entity ) );
 
     entity_count = 0;
-    for( [[maybe_unused]]std::pair<const tripoint_abs_ms, horde_entity> &entity : test_horde ) {
+    for( [[maybe_unused]]horde_entity_ref entity : test_horde ) {
         entity_count++;
     }
     CHECK( entity_count == 6 );
@@ -124,14 +130,68 @@ TEST_CASE( "horde_map_corner_cases", "[hordes]" )
 {
     // Make sure iterator handling is ok with empty container.
     horde_map test_horde;
-    for( [[maybe_unused]]std::pair<const tripoint_abs_ms, horde_entity> &entity : test_horde ) {
+    for( [[maybe_unused]]horde_entity_ref entity : test_horde ) {
         FAIL( "Unreachable loop entered, should not happen with empty horde_map." );
     }
     // Populated container but accessed in a way that filters out everything.
     place_entity( test_horde, mon_zombie );
-    for( [[maybe_unused]]std::pair<const tripoint_abs_ms, horde_entity> &entity : test_horde.get_view(
+    for( [[maybe_unused]]horde_entity_ref entity : test_horde.get_view(
              horde_map_flavors::active ) ) {
         FAIL( "Unreachable loop entered, should not happen with empty horde_map." );
     }
 
 }
+
+TEST_CASE( "horde_map_packed_storage_round_trip", "[hordes]" )
+{
+    horde_map test_horde;
+    test_horde.set_location( point_abs_om( 42, 42 ) );
+    // All in the same submap so they share a chunk and its monster side table.
+    const tripoint_om_ms first_loc( 1, 1, 0 );
+    const tripoint_om_ms second_loc( 2, 1, 0 );
+    const tripoint_om_ms light_loc( 3, 1, 0 );
+    const tripoint_abs_ms first_pos = project_combine( test_horde.get_location(), first_loc );
+
+    monster first_monster( mon_zombie );
+    first_monster.set_hp( 7 );
+    test_horde.spawn_entity( first_pos, first_monster );
+    monster second_monster( mon_zombie );
+    second_monster.set_hp( 11 );
+    test_horde.spawn_entity( project_combine( test_horde.get_location(), second_loc ),
+                             second_monster );
+    test_horde.spawn_entity( project_combine( test_horde.get_location(), light_loc ), mon_zombie );
+    REQUIRE( count_entities( test_horde, horde_map_flavors::idle ) == 3 );
+
+    std::optional<horde_entity_ref> light = test_horde.entity_at( light_loc );
+    REQUIRE( light );
+    CHECK( light->monster_data() == nullptr );
+    CHECK( light->type_id() == mon_zombie.id() );
+    CHECK( light->pos() == project_combine( test_horde.get_location(), light_loc ) );
+
+    // Taking the first monster out must leave the second one with its own data.
+    horde_map::iterator first_iter = test_horde.find( first_loc );
+    REQUIRE( first_iter != test_horde.end() );
+    horde_entity first_entity = test_horde.extract( first_iter );
+    REQUIRE( first_entity.monster_data );
+    CHECK( first_entity.monster_data->get_hp() == 7 );
+    std::optional<horde_entity_ref> second = test_horde.entity_at( second_loc );
+    REQUIRE( second );
+    REQUIRE( second->monster_data() != nullptr );
+    CHECK( second->monster_data()->get_hp() == 11 );
+
+    // Giving it a goal moves it to the active entities, which keep their goal.
+    const tripoint_abs_ms destination = random_abs_location( test_horde );
+    first_entity.tracking_intensity = 100;
+    first_entity.destination = destination;
+    first_entity.moves = 100000;
+    test_horde.insert( first_pos, std::move( first_entity ) );
+    CHECK( count_entities( test_horde, horde_map_flavors::active ) == 1 );
+    std::optional<horde_entity_ref> first = test_horde.entity_at( first_loc );
+    REQUIRE( first );
+    CHECK( first->is_active() );
+    CHECK( first->destination() == destination );
+    CHECK( first->tracking_intensity() == 100 );
+    CHECK( first->moves() == std::numeric_limits<int16_t>::max() );
+    REQUIRE( first->monster_data() != nullptr );
+    CHECK( first->monster_data()->get_hp() == 7 );
+}
@@ -24,6 +24,8 @@
 #include "vpart_range.h"
 #include "weather_type.h"
 
+static const efftype_id effect_haslight( "haslight" );
+
 static const field_type_str_id field_fd_test_green_glow( "fd_test_green_glow" );
 static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
 static const ter_str_id ter_t_flat_roof( "t_flat_roof" );
@@ -384,3 +386,89 @@ TEST_CASE( "vehicle_cone_light_carries_color", "[light_color]" )
 
     CHECK( best_r > behind_color.r );
 }
+
+TEST_CASE( "unchanged_lightmap_is_kept", "[light_color][lightmap]" )
+{
+    setup_dark_map();
+    scoped_weather_override weather_clear( WEATHER_CLEAR );
+    map &here = get_map();
+
+    const tripoint_bub_ms src = get_player_character().pos_bub() + tripoint::east * 3;
+    place_ter_roofed( src, ter_t_test_red_light );
+    rebuild_lightmap( 0 );
+    REQUIRE( get_light_color_at( src ).r > 0.0f );
+
+    // Tamper with the cache to tell a kept lightmap from a rebuilt one
+    here.access_cache( 0 ).light_color_cache[src.x()][src.y()] = light_color_rgb{ 0.0f, 0.0f, 1.0f };
+    here.build_map_cache( 0 );
+    CHECK( get_light_color_at( src ).b == 1.0f );
+
+    SECTION( "changed light sources rebuild it" ) {
+        get_player_character().add_effect( effect_haslight, 1_hours );
+        here.build_map_cache( 0 );
+        CHECK( get_light_color_at( src ).b == 0.0f );
+        CHECK( get_light_color_at( src ).r > 0.0f );
+    }
+
+    SECTION( "changed light blockers rebuild it" ) {
+        here.ter_set( src + tripoint::west, ter_t_brick_wall.id() );
+        here.build_map_cache( 0 );
+        CHECK( get_light_color_at( src ).b == 0.0f );
+        CHECK( get_light_color_at( src ).r > 0.0f );
+    }
+}
+
+TEST_CASE( "static_light_follows_its_blockers", "[light_color][lightmap]" )
+{
+    setup_dark_map();
+    scoped_weather_override weather_clear( WEATHER_CLEAR );
+    map &here = get_map();
+
+    const tripoint_bub_ms src = get_player_character().pos_bub() + tripoint::east * 3;
+    const tripoint_bub_ms behind = src + tripoint::east * 2;
+    place_ter_roofed( src, ter_t_test_red_light );
+    rebuild_lightmap( 0 );
+    const float red_behind = get_light_color_at( behind ).r;
+    REQUIRE( red_behind > 0.0f );
+
+    SECTION( "other light sources changing keep it" ) {
+        get_player_character().add_effect( effect_haslight, 1_hours );
+        here.build_map_cache( 0 );
+        CHECK( get_light_color_at( behind ).r == red_behind );
+    }
+
+    SECTION( "a wall in front of it shades it" ) {
+        here.ter_set( src + tripoint::east, ter_t_brick_wall.id() );
+        here.build_map_cache( 0 );
+        CHECK( get_light_color_at( behind ).r < red_behind );
+    }
+}
+
+TEST_CASE( "lightmap_benchmark", "[.][light_color][lightmap][benchmark]" )
+{
+    setup_dark_map();
+    scoped_weather_override weather_clear( WEATHER_CLEAR );
+    map &here = get_map();
+
+    const tripoint_bub_ms center = get_player_character().pos_bub();
+    for( int dx = -40; dx <= 40; dx += 10 ) {
+        for( int dy = -40; dy <= 40; dy += 10 ) {
+            if( dx != 0 || dy != 0 ) {
+                place_ter_roofed( center + tripoint( dx, dy, 0 ), ter_test_t_utility_light );
+            }
+        }
+    }
+    rebuild_lightmap( 0 );
+
+    BENCHMARK( "lightmap with nothing changed" ) {
+        here.build_map_cache( 0 );
+        return here.access_cache( 0 ).lm[center.x()][center.y()].max();
+    };
+    // Around dawn the natural light changes every minute
+    calendar::turn = calendar::turn_zero + 6_hours;
+    BENCHMARK( "lightmap while the sun moves" ) {
+        calendar::turn += 1_minutes;
+        here.build_map_cache( 0 );
+        return here.access_cache( 0 ).lm[center.x()][center.y()].max();
+    };
+}
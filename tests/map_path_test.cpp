@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -9,6 +10,7 @@
 #include "coordinates.h"
 #include "field_type.h"
 #include "game.h"
+#include "line.h"
 #include "map.h"
 #include "map_helpers.h"
 #include "map_iterator.h"
@@ -649,3 +651,187 @@ TEST_CASE( "map_route_mon_around_danger", "[map][pathfinding]" )
     }
     clear_map_without_vision();
 }
+
+// Cost of a route over open floor, as map::route() reckons it.
+static int floor_route_cost( const tripoint_bub_ms &from, const std::vector<tripoint_bub_ms> &path )
+{
+    int cost = 0;
+    tripoint_bub_ms prev = from;
+    for( const tripoint_bub_ms &p : path ) {
+        cost += 2 + ( prev.x() != p.x() && prev.y() != p.y() ? 1 : 0 );
+        prev = p;
+    }
+    return cost;
+}
+
+TEST_CASE( "map_route_shared_between_many_creatures", "[map][pathfinding]" )
+{
+    map &m = setup_map_without_obstacles();
+    place_player_at( tripoint_bub_ms{ 65, 65, 0 } );
+    // A wall between the creatures and the target, so that there's no straight route.
+    std::vector<tripoint_bub_ms> wall;
+    for( int y = 55; y <= 75; ++y ) {
+        wall.emplace_back( 70, y, 0 );
+    }
+    place_obstacle( m, wall );
+    const pathfinding_target target = pathfinding_target::point( tripoint_bub_ms{ 75, 65, 0 } );
+    pathfinding_settings settings;
+    settings.max_dist = 60;
+    settings.max_length = 240;
+    const std::vector<tripoint_bub_ms> starts = {
+        { 60, 60, 0 }, { 60, 65, 0 }, { 62, 70, 0 }, { 58, 64, 0 }, { 61, 66, 0 }, { 66, 74, 0 }
+    };
+
+    // Routes are only shared between the creatures asking for them on the same turn.
+    std::vector<int> separate_costs;
+    for( const tripoint_bub_ms &start : starts ) {
+        calendar::turn += 1_turns;
+        const std::vector<tripoint_bub_ms> path = m.route( start, target, settings );
+        REQUIRE( !path.empty() );
+        separate_costs.push_back( floor_route_cost( start, path ) );
+    }
+
+    calendar::turn += 1_turns;
+    for( size_t i = 0; i < starts.size(); ++i ) {
+        CAPTURE( starts[i] );
+        const std::vector<tripoint_bub_ms> path = m.route( starts[i], target, settings );
+        REQUIRE( !path.empty() );
+        CHECK( path.back() == target.center );
+        tripoint_bub_ms prev = starts[i];
+        for( const tripoint_bub_ms &p : path ) {
+            CHECK( rl_dist( prev, p ) == 1 );
+            CHECK( m.passable( p ) );
+            prev = p;
+        }
+        CHECK( floor_route_cost( starts[i], path ) == separate_costs[i] );
+    }
+
+    WHEN( "a creature has to avoid the shared route" ) {
+        const tripoint_bub_ms gap{ 70, 54, 0 };
+        const std::vector<tripoint_bub_ms> path = m.route( starts[0], target, settings,
+        [&]( const tripoint_bub_ms & p ) {
+            return p == gap;
+        } );
+        THEN( "it gets a route of its own" ) {
+            REQUIRE( !path.empty() );
+            CHECK( std::find( path.begin(), path.end(), gap ) == path.end() );
+        }
+    }
+    clear_map_without_vision();
+}
+
+TEST_CASE( "map_route_long_distance", "[map][pathfinding]" )
+{
+    map &m = setup_map_without_obstacles();
+    place_player_at( tripoint_bub_ms{ 65, 65, 0 } );
+    const tripoint_bub_ms start{ 20, 60, 0 };
+    const pathfinding_target target = pathfinding_target::point( tripoint_bub_ms{ 80, 60, 0 } );
+    pathfinding_settings settings;
+    settings.max_dist = 100;
+    settings.max_length = 400;
+    const tripoint_bub_ms opening{ 50, 70, 0 };
+    std::vector<tripoint_bub_ms> wall;
+    for( int y = 30; y <= 90; ++y ) {
+        if( y != opening.y() ) {
+            wall.emplace_back( 50, y, 0 );
+        }
+    }
+    place_obstacle( m, wall );
+
+    const auto check_route = [&]( const std::vector<tripoint_bub_ms> &path ) {
+        REQUIRE( !path.empty() );
+        CHECK( path.back() == target.center );
+        tripoint_bub_ms prev = start;
+        for( const tripoint_bub_ms &p : path ) {
+            CHECK( rl_dist( prev, p ) == 1 );
+            prev = p;
+        }
+        CHECK( std::find( path.begin(), path.end(), opening ) != path.end() );
+    };
+
+    GIVEN( "an opening in the wall" ) {
+        check_route( m.route( start, target, settings ) );
+    }
+    GIVEN( "a door in the wall, with no way around over open ground" ) {
+        m.ter_set( opening, ter_id( "t_door_c" ) );
+        clear_map_caches( m );
+        settings.allow_open_doors = true;
+        check_route( m.route( start, target, settings ) );
+    }
+    clear_map_without_vision();
+}
+
+TEST_CASE( "map_route_from_avoid_callback", "[map][pathfinding]" )
+{
+    map &m = setup_map_without_obstacles();
+    place_player_at( tripoint_bub_ms{ 65, 65, 0 } );
+    std::vector<tripoint_bub_ms> wall;
+    for( int y = 40; y <= 80; ++y ) {
+        if( y != 70 ) {
+            wall.emplace_back( 60, y, 0 );
+        }
+    }
+    place_obstacle( m, wall );
+    pathfinding_settings settings;
+    settings.max_dist = 100;
+    settings.max_length = 400;
+    const tripoint_bub_ms start{ 40, 50, 0 };
+    const pathfinding_target target = pathfinding_target::point( tripoint_bub_ms{ 75, 60, 0 } );
+    const tripoint_bub_ms avoided{ 59, 69, 0 };
+    const std::vector<tripoint_bub_ms> expected = m.route( start, target, settings,
+    [&]( const tripoint_bub_ms & p ) {
+        return p == avoided;
+    } );
+    REQUIRE( !expected.empty() );
+
+    // A search started while another is running must not disturb it.
+    std::vector<tripoint_bub_ms> inner;
+    const std::vector<tripoint_bub_ms> outer = m.route( start, target, settings,
+    [&]( const tripoint_bub_ms & p ) {
+        if( inner.empty() ) {
+            inner = m.route( tripoint_bub_ms{ 75, 45, 0 }, pathfinding_target::point( start ), settings );
+        }
+        return p == avoided;
+    } );
+    CHECK( !inner.empty() );
+    CHECK( outer == expected );
+    clear_map_without_vision();
+}
+
+TEST_CASE( "map_route_benchmark", "[.][map][pathfinding][benchmark]" )
+{
+    map &m = setup_map_without_obstacles();
+    place_player_at( tripoint_bub_ms{ 65, 65, 0 } );
+    std::vector<tripoint_bub_ms> wall;
+    for( int y = 40; y <= 80; ++y ) {
+        if( y != 70 ) {
+            wall.emplace_back( 60, y, 0 );
+        }
+    }
+    place_obstacle( m, wall );
+    pathfinding_settings settings;
+    settings.max_dist = 100;
+    settings.max_length = 400;
+
+    // Targets with a radius are never served from a shared flow field, so these time the search.
+    BENCHMARK( "short route around a wall" ) {
+        return m.route( tripoint_bub_ms{ 50, 60, 0 },
+                        pathfinding_target::radius( tripoint_bub_ms{ 70, 60, 0 }, 1 ), settings );
+    };
+    BENCHMARK( "long route" ) {
+        return m.route( tripoint_bub_ms{ 20, 60, 0 },
+                        pathfinding_target::radius( tripoint_bub_ms{ 110, 60, 0 }, 1 ), settings );
+    };
+    BENCHMARK( "twenty routes to one target" ) {
+        // A new turn each time, so the flow field is built rather than reused.
+        calendar::turn += 1_turns;
+        const tripoint_bub_ms target{ 75, 60, 0 };
+        std::size_t length = 0;
+        for( int i = 0; i < 20; ++i ) {
+            length += m.route( tripoint_bub_ms{ 30 + i, 45 + i, 0 }, pathfinding_target::point( target ),
+                               settings ).size();
+        }
+        return length;
+    };
+    clear_map_without_vision();
+}
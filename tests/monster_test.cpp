@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <bitset>
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
@@ -23,7 +24,7 @@
 #include "debug.h"
 #include "creature_tracker.h"
 #include "game.h"
-#include "horde_entity.h"
+#include "horde_map.h"
 #include "item.h"
 #include "line.h"
 #include "map.h"
@@ -827,11 +828,11 @@ TEST_CASE( "monster_can_navigate_from_overmap_to_reality_bubble", "[monster][hor
     overmap_buffer.alert_entity( spawn_location, m.get_abs( destination ), 100 );
     // This reference will be invalidated once the monster spawns in the reality bubble,
     // don't access it again after calling move_hordes().
-    horde_entity *test_entity = overmap_buffer.entity_at( spawn_location );
-    REQUIRE( test_entity != nullptr );
+    std::optional<horde_entity_ref> test_entity = overmap_buffer.entity_at( spawn_location );
+    REQUIRE( test_entity );
     REQUIRE( test_entity->is_active() );
-    REQUIRE( test_entity->destination == m.get_abs( destination ) );
-    REQUIRE( test_entity->tracking_intensity > 0 );
+    REQUIRE( test_entity->destination() == m.get_abs( destination ) );
+    REQUIRE( test_entity->tracking_intensity() > 0 );
     // Process hordes and verify the monster appears on the reality bubble.
     int num_steps = 0;
     do {
@@ -855,21 +856,22 @@ TEST_CASE( "monster_can_navigate_from_overmap_to_reality_bubble_following_sound"
     // Place monster on the local overmap.monster_map just outside the reality bubble.
     map &m = get_map();
     tripoint_abs_ms entity_spawn_location( m.get_abs( { -12, 66, 0 } ) );
-    horde_entity &test_mon_initial = overmap_buffer.spawn_monster( entity_spawn_location,
-                                     mon_test_zombie );
+    std::optional<horde_entity_ref> test_mon_initial = overmap_buffer.spawn_monster(
+                entity_spawn_location, mon_test_zombie );
+    REQUIRE( test_mon_initial );
     // Assert monster is not wandering
-    REQUIRE( test_mon_initial.tracking_intensity == 0 );
+    REQUIRE( test_mon_initial->tracking_intensity() == 0 );
     // Give the monster a goal location inside the bubble by making a loud noise.
     std::string test_sound( "test sound" );
     sound( destination, 200, sounds::sound_t::combat, test_sound );
     sounds::process_sounds();
     // Assert monster is wandering
-    horde_entity *test_mon = overmap_buffer.entity_at( entity_spawn_location );
-    REQUIRE( test_mon != nullptr );
-    REQUIRE( test_mon->tracking_intensity > 0 );
-    CAPTURE( test_mon->tracking_intensity );
-    CAPTURE( test_mon->destination );
-    tripoint_bub_ms actual_destination = m.get_bub( test_mon->destination );
+    std::optional<horde_entity_ref> test_mon = overmap_buffer.entity_at( entity_spawn_location );
+    REQUIRE( test_mon );
+    REQUIRE( test_mon->tracking_intensity() > 0 );
+    CAPTURE( test_mon->tracking_intensity() );
+    CAPTURE( test_mon->destination() );
+    tripoint_bub_ms actual_destination = m.get_bub( test_mon->destination() );
     REQUIRE( rl_dist( actual_destination, destination ) <= 12 );
     // This reference will be invalidated once the monster spawns in the reality bubble,
     // don't access it again after calling move_hordes().
@@ -885,6 +887,155 @@ TEST_CASE( "monster_can_navigate_from_overmap_to_reality_bubble_following_sound"
     test_move_to_location( local_test_monster, actual_destination );
 }
 
+// Sends a column of entities, one per submap, west across the overmap and returns how far
+// each of them got.
+static std::vector<int> move_horde_column( int turns )
+{
+    clear_map_and_put_player_underground();
+    // Both runs start on the same turn.
+    calendar::turn = calendar::turn_zero + 1_hours;
+    map &m = get_map();
+    const int entities = 5;
+    for( int i = 0; i < entities; ++i ) {
+        const tripoint_abs_ms start = m.get_abs( { -30, 12 * i + 6, 0 } );
+        REQUIRE( overmap_buffer.spawn_monster( start, mon_test_zombie ) );
+        overmap_buffer.alert_entity( start, m.get_abs( { -80, 12 * i + 6, 0 } ), 100 );
+    }
+    // Alerted entities move on the turn they were alerted.
+    for( int turn = 0; turn < turns; ++turn ) {
+        overmap_buffer.move_hordes();
+        calendar::turn += 1_turns;
+    }
+    // Let every submap come up, once for every step an entity still owes, without advancing
+    // time, which only catches entities up.
+    for( int i = 0; i < entities * turns; ++i ) {
+        overmap_buffer.move_hordes();
+    }
+    std::vector<int> travelled;
+    for( int i = 0; i < entities; ++i ) {
+        int distance = -1;
+        for( int x = 0; x <= 50 && distance < 0; ++x ) {
+            if( overmap_buffer.entity_at( m.get_abs( { -30 - x, 12 * i + 6, 0 } ) ) ) {
+                distance = x;
+            }
+        }
+        travelled.push_back( distance );
+    }
+    return travelled;
+}
+
+TEST_CASE( "throttled_horde_movement_catches_up", "[monster][hordes]" )
+{
+    std::vector<int> unthrottled;
+    {
+        override_option budget( "HORDE_MOVE_BUDGET", "0" );
+        // Finish whatever sweep earlier tests left behind, so that the column starts a new one.
+        overmap_buffer.move_hordes();
+        unthrottled = move_horde_column( 10 );
+    }
+    CAPTURE( unthrottled );
+    for( int distance : unthrottled ) {
+        REQUIRE( distance > 0 );
+    }
+    // However small the budget, each overmap moves the entities of one submap per turn.
+    override_option budget( "HORDE_MOVE_BUDGET", "1" );
+    CHECK( move_horde_column( 10 ) == unthrottled );
+}
+
+TEST_CASE( "horde_catch_up_is_limited", "[monster][hordes]" )
+{
+    override_option budget( "HORDE_MOVE_BUDGET", "0" );
+    overmap_buffer.move_hordes();
+    clear_map_and_put_player_underground();
+    calendar::turn = calendar::turn_zero + 1_hours;
+    map &m = get_map();
+    const tripoint_abs_ms start = m.get_abs( { -30, 6, 0 } );
+    REQUIRE( overmap_buffer.spawn_monster( start, mon_test_zombie ) );
+    overmap_buffer.alert_entity( start, m.get_abs( { -200, 6, 0 } ), 1000 );
+    overmap_buffer.move_hordes();
+    // Ten minutes without moving, of which only one is caught up on.
+    calendar::turn += 10_minutes;
+    overmap_buffer.move_hordes();
+    int distance = -1;
+    for( int x = 0; x <= 170 && distance < 0; ++x ) {
+        if( overmap_buffer.entity_at( m.get_abs( { -30 - x, 6, 0 } ) ) ) {
+            distance = x;
+        }
+    }
+    CHECK( distance > 10 );
+    CHECK( distance <= 61 );
+}
+
+TEST_CASE( "horde_entities_cross_overmap_boundaries", "[monster][hordes]" )
+{
+    clear_map_and_put_player_underground();
+    const point_abs_om home = project_to<coords::om>( get_player_character().pos_abs_omt().xy() );
+    const point_abs_om east = home + point::east;
+    overmap_buffer.get( east );
+    const point_abs_ms boundary = project_to<coords::ms>( east );
+    const tripoint_abs_ms start( boundary + point( -3, 5 ), 0 );
+    const tripoint_abs_ms destination( boundary + point( 6, 5 ), 0 );
+    std::bitset<24 * 24> open;
+    open.set();
+    overmap_buffer.set_passable( project_to<coords::omt>( start ), open );
+    overmap_buffer.set_passable( project_to<coords::omt>( destination ), open );
+
+    REQUIRE( overmap_buffer.spawn_monster( start, mon_test_zombie ) );
+    overmap_buffer.alert_entity( start, destination, 100 );
+    for( int turn = 0; turn < 10; ++turn ) {
+        calendar::turn += 1_turns;
+        overmap_buffer.move_hordes();
+    }
+    std::vector<int> found;
+    for( int x = -3; x <= 6; ++x ) {
+        if( overmap_buffer.entity_at( tripoint_abs_ms( boundary + point( x, 5 ), 0 ) ) ) {
+            found.push_back( x );
+        }
+    }
+    // Exactly one entity, which made it onto the other overmap.
+    CAPTURE( found );
+    REQUIRE( found.size() == 1 );
+    CHECK( found.front() >= 0 );
+}
+
+TEST_CASE( "horde_entities_sidestep_entities_on_other_overmaps", "[monster][hordes]" )
+{
+    clear_map_and_put_player_underground();
+    const point_abs_om home = project_to<coords::om>( get_player_character().pos_abs_omt().xy() );
+    const point_abs_om east = home + point::east;
+    overmap_buffer.get( east );
+    const point_abs_ms boundary = project_to<coords::ms>( east );
+    const tripoint_abs_ms start( boundary + point( -1, 5 ), 0 );
+    const tripoint_abs_ms blocked( boundary + point( 0, 5 ), 0 );
+    const tripoint_abs_ms destination( boundary + point( 6, 5 ), 0 );
+    std::bitset<24 * 24> open;
+    open.set();
+    overmap_buffer.set_passable( project_to<coords::omt>( start ), open );
+    overmap_buffer.set_passable( project_to<coords::omt>( destination ), open );
+
+    // An idle entity right in the way, on the other overmap.
+    REQUIRE( overmap_buffer.spawn_monster( blocked, mon_test_zombie ) );
+    REQUIRE( overmap_buffer.spawn_monster( start, mon_test_zombie ) );
+    overmap_buffer.alert_entity( start, destination, 100 );
+    for( int turn = 0; turn < 10; ++turn ) {
+        calendar::turn += 1_turns;
+        overmap_buffer.move_hordes();
+    }
+    CHECK( overmap_buffer.entity_at( blocked ) );
+    CHECK( !overmap_buffer.entity_at( start ) );
+    std::vector<point> found;
+    for( int y = 2; y <= 8; ++y ) {
+        for( int x = 0; x <= 6; ++x ) {
+            const tripoint_abs_ms p( boundary + point( x, y ), 0 );
+            if( p != blocked && overmap_buffer.entity_at( p ) ) {
+                found.emplace_back( x, y );
+            }
+        }
+    }
+    CAPTURE( found );
+    CHECK( found.size() == 1 );
+}
+
 TEST_CASE( "monster_moved_to_overmap_after_map_shift", "[monster][hordes]" )
 {
     clear_map_without_vision();
@@ -927,6 +1078,24 @@ TEST_CASE( "monster_moved_to_overmap_after_map_shift", "[monster][hordes]" )
 }
 
 
+TEST_CASE( "monsters_hear_sounds_within_range", "[monster][sound]" )
+{
+    clear_map_and_put_player_underground();
+    // Clear lingering sounds from queue.
+    sounds::process_sounds();
+    const tripoint_bub_ms source{ 50, 50, 0 };
+    monster &near = spawn_test_monster( "mon_test_zombie", source + tripoint_rel_ms( 3, 2, 0 ) );
+    monster &far = spawn_test_monster( "mon_test_zombie", source + tripoint_rel_ms( 45, 0, 0 ) );
+    REQUIRE( near.wandf == 0 );
+    REQUIRE( far.wandf == 0 );
+
+    sounds::sound( source, 20, sounds::sound_t::alert, "test sound" );
+    sounds::process_sounds();
+    CHECK( near.wandf > 0 );
+    CHECK( rl_dist( near.wander_pos, get_map().get_abs( source ) ) <= 1 );
+    CHECK( far.wandf == 0 );
+}
+
 TEST_CASE( "monster_cant_enter_reality_bubble_because_wall", "[monster][hordes]" )
 {
     // Remove interacting with the player as a complication.
@@ -985,10 +1154,10 @@ static void walk_toward_monster_off_the_map( tripoint_abs_omt origin, point offs
     // Verify we don't try to spawn the monster on a "tainted" area of the map.
     REQUIRE( !here.inbounds( monster_pos ) );
     // Place monster in overmap::monster_map off the edge of the reality bubble.
-    REQUIRE( nullptr == overmap_buffer.entity_at( monster_pos ) );
+    REQUIRE( !overmap_buffer.entity_at( monster_pos ) );
     REQUIRE( overmap_buffer.passable( monster_pos ) );
     overmap_buffer.spawn_monster( monster_pos, id );
-    REQUIRE( nullptr != overmap_buffer.entity_at( monster_pos ) );
+    REQUIRE( overmap_buffer.entity_at( monster_pos ) );
 
     // move player toward monster, triggering map shifts
     int num_steps = 0;
@@ -1038,7 +1207,7 @@ static void walk_toward_monster_off_the_map( tripoint_abs_omt origin, point offs
     tripoint_bub_ms actual_local = here.get_bub( tgt_monster->pos_abs() );
     CAPTURE( actual_local );
     CHECK( square_dist( actual_local, expected_local ) <= 1 );
-    CHECK( nullptr == overmap_buffer.entity_at( monster_pos ) );
+    CHECK( !overmap_buffer.entity_at( monster_pos ) );
 }
 
 static void dormant_monsters_spawn_correctly( const tripoint_abs_omt &origin )
@@ -1145,19 +1314,19 @@ TEST_CASE( "failed_horde_placement_preserves_entity", "[monster][hordes]" )
             here.ter_set( p, ter_t_palisade );
         }
         overmap_buffer.spawn_monster( abs_pos, mon_test_zombie );
-        horde_entity *entity = overmap_buffer.entity_at( abs_pos );
-        REQUIRE( entity != nullptr );
-        REQUIRE( entity->monster_data == nullptr );
+        std::optional<horde_entity_ref> entity = overmap_buffer.entity_at( abs_pos );
+        REQUIRE( entity );
+        REQUIRE( entity->monster_data() == nullptr );
 
         overmap_buffer.spawn_monster( submap_pos );
-        CHECK( overmap_buffer.entity_at( abs_pos ) != nullptr );
+        CHECK( overmap_buffer.entity_at( abs_pos ) );
 
         // Unblock and retry.
         for( const tripoint_bub_ms &p : here.points_in_radius( local_pos, 1 ) ) {
             here.ter_set( p, ter_t_grass );
         }
         overmap_buffer.spawn_monster( submap_pos );
-        CHECK( overmap_buffer.entity_at( abs_pos ) == nullptr );
+        CHECK( !overmap_buffer.entity_at( abs_pos ) );
         CHECK( get_creature_tracker().creature_at<monster>( abs_pos ) != nullptr );
     }
 
@@ -1167,9 +1336,9 @@ TEST_CASE( "failed_horde_placement_preserves_entity", "[monster][hordes]" )
         monster *live = g->place_critter_at( mon_test_zombie, local_pos );
         REQUIRE( live != nullptr );
         g->despawn_monster( *live );
-        horde_entity *entity = overmap_buffer.entity_at( abs_pos );
-        REQUIRE( entity != nullptr );
-        REQUIRE( entity->monster_data != nullptr );
+        std::optional<horde_entity_ref> entity = overmap_buffer.entity_at( abs_pos );
+        REQUIRE( entity );
+        REQUIRE( entity->monster_data() != nullptr );
 
         // Block center with another monster so critter_tracker::add fails.
         monster *blocker = g->place_critter_at( mon_test_zombie, local_pos );
@@ -1178,12 +1347,12 @@ TEST_CASE( "failed_horde_placement_preserves_entity", "[monster][hordes]" )
         capture_debugmsg_during( [&submap_pos]() {
             overmap_buffer.spawn_monster( submap_pos );
         } );
-        CHECK( overmap_buffer.entity_at( abs_pos ) != nullptr );
+        CHECK( overmap_buffer.entity_at( abs_pos ) );
 
         // Remove blocker and retry.
         g->remove_zombie( *blocker );
         overmap_buffer.spawn_monster( submap_pos );
-        CHECK( overmap_buffer.entity_at( abs_pos ) == nullptr );
+        CHECK( !overmap_buffer.entity_at( abs_pos ) );
         CHECK( get_creature_tracker().creature_at<monster>( abs_pos ) != nullptr );
     }
 }
@@ -55,6 +55,8 @@ static const oter_str_id oter_cabin_east( "cabin_east" );
 static const oter_str_id oter_cabin_north( "cabin_north" );
 static const oter_str_id oter_cabin_south( "cabin_south" );
 static const oter_str_id oter_cabin_west( "cabin_west" );
+static const oter_str_id oter_field( "field" );
+static const oter_str_id oter_lake_surface( "lake_surface" );
 
 static const overmap_special_id overmap_special_Cabin( "Cabin" );
 static const overmap_special_id overmap_special_Lab( "Lab" );
@@ -1105,3 +1107,66 @@ TEST_CASE( "overmap_generation_is_deterministic", "[overmap]" )
         }
     }
 }
+
+static bool is_connected_path( const std::vector<tripoint_abs_omt> &path )
+{
+    for( size_t i = 1; i < path.size(); ++i ) {
+        if( rl_dist( path[i - 1], path[i] ) != 1 ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE( "overmap_travel_paths_are_reused", "[overmap][pathfinding]" )
+{
+    // A field fenced in by lake, so that nothing outside of it can make a shorter path
+    clear_overmaps();
+    const tripoint_abs_omt corner( 10, 10, 0 );
+    for( const tripoint_abs_omt &p : tripoint_range<tripoint_abs_omt>( corner,
+            corner + tripoint( 20, 20, 0 ) ) ) {
+        const bool border = p.x() == corner.x() || p.y() == corner.y() ||
+                            p.x() == corner.x() + 20 || p.y() == corner.y() + 20;
+        overmap_buffer.ter_set( p, border ? oter_lake_surface : oter_field );
+    }
+    const overmap_path_params params = overmap_path_params::for_npc();
+    const tripoint_abs_omt src = corner + tripoint( 2, 10, 0 );
+    const tripoint_abs_omt dest = corner + tripoint( 18, 10, 0 );
+
+    const std::vector<tripoint_abs_omt> path = overmap_buffer.get_cached_travel_path( src, dest,
+            params );
+    REQUIRE( !path.empty() );
+    CHECK( path.front() == dest );
+    CHECK( path.back() == src );
+    CHECK( path == overmap_buffer.get_travel_path( src, dest, params ).points );
+    const size_t middle = path.size() / 2;
+
+    SECTION( "sources on a known path get the rest of it" ) {
+        const std::vector<tripoint_abs_omt> rest( path.begin(), path.begin() + middle + 1 );
+        CHECK( overmap_buffer.get_cached_travel_path( path[middle], dest, params ) == rest );
+    }
+
+    SECTION( "sources next to a known path are routed back onto it" ) {
+        const tripoint_abs_omt off_path = path[middle] + tripoint( 0, 3, 0 );
+        const std::vector<tripoint_abs_omt> rejoined = overmap_buffer.get_cached_travel_path(
+                    off_path, dest, params );
+        REQUIRE( !rejoined.empty() );
+        CHECK( rejoined.front() == dest );
+        CHECK( rejoined.back() == off_path );
+        CHECK( is_connected_path( rejoined ) );
+    }
+
+    SECTION( "terrain changes drop known paths" ) {
+        // Flood the middle of the field, leaving a gap at the top
+        for( int y = corner.y() + 3; y < corner.y() + 20; ++y ) {
+            overmap_buffer.ter_set( tripoint_abs_omt( path[middle].x(), y, 0 ), oter_lake_surface );
+        }
+        const std::vector<tripoint_abs_omt> detour = overmap_buffer.get_cached_travel_path( src, dest,
+                params );
+        REQUIRE( !detour.empty() );
+        CHECK( is_connected_path( detour ) );
+        for( const tripoint_abs_omt &p : detour ) {
+            CHECK( overmap_buffer.ter( p ) != oter_lake_surface.id() );
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#include "cata_catch.h"
+#include "character.h"
+#include "coordinates.h"
+#include "cuboid_rectangle.h"
+#include "game.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "player_helpers.h"
+#include "point.h"
+#include "scent_map.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_wall( "t_wall" );
+
+TEST_CASE( "scent_spreads_around_but_not_through_walls", "[scent]" )
+{
+    clear_map();
+    clear_avatar();
+    map &here = get_map();
+    scent_map &scent = get_scent();
+    scent.reset();
+
+    const tripoint_bub_ms center = get_player_character().pos_bub();
+    const tripoint_bub_ms source = center + point( 5, 0 );
+    for( int dy = -5; dy <= 5; ++dy ) {
+        here.ter_set( source + point( 2, dy ), ter_t_wall );
+    }
+    REQUIRE( here.has_flag( ter_furn_flag::TFLAG_NO_SCENT, source + point( 2, 0 ) ) );
+
+    scent.set( source, 5000 );
+    scent.update( center, here );
+    scent.update( center, here );
+
+    CHECK( scent.get( source ) > 0 );
+    CHECK( scent.get( source + point::west * 2 ) > 0 );
+    CHECK( scent.get( source + point::north * 2 ) > 0 );
+    CHECK( scent.get( source + point::east ) > 0 );
+    CHECK( scent.get( source + point( 2, 0 ) ) == 0 );
+    CHECK( scent.get( source + point( 3, 0 ) ) == 0 );
+    // Scent spreads a square per update at most
+    CHECK( scent.get( source + point::west * 3 ) == 0 );
+
+    scent.reset();
+}
+
+namespace
+{
+// Exposes the area scent_map::update() works on
+class scent_map_with_area : public scent_map
+{
+    public:
+        using scent_map::scent_map;
+        const inclusive_rectangle<point_bub_ms> &area() const {
+            return scented_area;
+        }
+};
+} // namespace
+
+TEST_CASE( "scented_area_shrinks_as_scent_fades", "[scent]" )
+{
+    clear_map();
+    clear_avatar();
+    map &here = get_map();
+    scent_map_with_area scent( *g );
+    scent.reset();
+
+    const tripoint_bub_ms center = get_player_character().pos_bub();
+    const tripoint_bub_ms source = center + point( 5, 0 );
+    scent.set( source, 20 );
+    for( int i = 0; i < 3; ++i ) {
+        scent.update( center, here );
+    }
+    CHECK( scent.area().contains( source.xy() ) );
+    CHECK( scent.area().p_max.x() - scent.area().p_min.x() <= 6 );
+
+    // Far fewer updates than it would take the area to cover the whole scent radius
+    for( int i = 0; i < 30; ++i ) {
+        scent.update( center, here );
+    }
+    CHECK( scent.get( source ) == 0 );
+    CHECK( scent.area().p_min.x() > scent.area().p_max.x() );
+}
@@ -1136,6 +1136,94 @@ TEST_CASE( "shadowcasting_float_quad_performance", "[.]" )
     shadowcasting_float_quad( 1000000, 100 );
 }
 
+TEST_CASE( "shadowcasting_equal_run_length", "[shadowcasting]" )
+{
+    // Long enough to cover whole batches, partial batches and the scalar tail in both directions.
+    constexpr int cells = 21;
+    for( int mismatch = 0; mismatch <= cells; ++mismatch ) {
+        std::array<float, cells> row;
+        row.fill( LIGHT_TRANSPARENCY_OPEN_AIR );
+        if( mismatch < cells ) {
+            row[mismatch] = LIGHT_TRANSPARENCY_SOLID;
+        }
+        for( int first = 0; first < cells; ++first ) {
+            CAPTURE( mismatch, first );
+            const int forward = mismatch >= first ? mismatch - first : cells - first;
+            CHECK( equal_run_length( &row[first], 1, cells - first,
+                                     LIGHT_TRANSPARENCY_OPEN_AIR ) == std::min( forward, cells - first ) );
+            const int backward = mismatch <= first ? first - mismatch : first;
+            CHECK( equal_run_length( &row[first], -1, first,
+                                     LIGHT_TRANSPARENCY_OPEN_AIR ) == std::min( backward, first ) );
+        }
+    }
+}
+
+TEST_CASE( "shadowcasting_batched_runs_match_tile_by_tile", "[shadowcasting]" )
+{
+    struct test_grids {
+        cata::mdarray<float, point_bub_ms> transparency_cache = {};
+        cata::mdarray<float, point_bub_ms> batched_float = {};
+        cata::mdarray<float, point_bub_ms> unbatched_float = {};
+        cata::mdarray<four_quadrants, point_bub_ms> batched_quad = {};
+        cata::mdarray<four_quadrants, point_bub_ms> unbatched_quad = {};
+    };
+    std::unique_ptr<test_grids> grids = std::make_unique<test_grids>();
+
+    // Long runs of open air broken up by walls and by smoke of a few densities, so that runs
+    // end on both a change of transparency and the edges of the light.
+    const std::array<float, 4> hazes = { { 0.02f, 0.04f, 0.08f, 0.2f } };
+    for( int iteration = 0; iteration < 20; ++iteration ) {
+        const int walls = rng( 2, 20 );
+        const int haze = rng( 0, 20 );
+        grids->transparency_cache.fill_from_callable( [&]() {
+            const int roll = rng( 0, 99 );
+            if( roll < walls ) {
+                return LIGHT_TRANSPARENCY_SOLID;
+            } else if( roll < walls + haze ) {
+                return random_entry( hazes );
+            }
+            return LIGHT_TRANSPARENCY_OPEN_AIR;
+        } );
+        const point_bub_ms offset( rng( 0, MAPSIZE_X - 1 ), rng( 0, MAPSIZE_Y - 1 ) );
+        const int offset_distance = rng( 0, 10 );
+        CAPTURE( iteration, walls, haze, offset, offset_distance );
+
+        grids->batched_float.fill( 0.0f );
+        grids->unbatched_float.fill( 0.0f );
+        grids->batched_quad.fill( four_quadrants( 0.0f ) );
+        grids->unbatched_quad.fill( four_quadrants( 0.0f ) );
+        castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+            grids->batched_float, grids->transparency_cache, offset, offset_distance );
+        castLightAll<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                     accumulate_transparency>(
+                         grids->batched_quad, grids->transparency_cache, offset, offset_distance,
+                         LIGHT_AMBIENT_LIT * 10 );
+        shadowcasting_batch_runs = false;
+        castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+            grids->unbatched_float, grids->transparency_cache, offset, offset_distance );
+        castLightAll<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                     accumulate_transparency>(
+                         grids->unbatched_quad, grids->transparency_cache, offset, offset_distance,
+                         LIGHT_AMBIENT_LIT * 10 );
+        shadowcasting_batch_runs = true;
+
+        int float_mismatches = 0;
+        int quad_mismatches = 0;
+        for( int x = 0; x < MAPSIZE_X; ++x ) {
+            for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                if( grids->batched_float[x][y] != grids->unbatched_float[x][y] ) {
+                    ++float_mismatches;
+                }
+                if( grids->batched_quad[x][y].values != grids->unbatched_quad[x][y].values ) {
+                    ++quad_mismatches;
+                }
+            }
+        }
+        CHECK( float_mismatches == 0 );
+        CHECK( quad_mismatches == 0 );
+    }
+}
+
 // I'm not sure this will ever work.
 TEST_CASE( "bresenham_vs_shadowcasting", "[.]" )
 {
@@ -0,0 +1,46 @@
+#include "cata_catch.h"
+#include "point.h"
+#include "skew_vision_cache.h"
+
+TEST_CASE( "skew_vision_cache_stores_and_forgets", "[nogame]" )
+{
+    skew_vision_cache cache;
+    CHECK( cache.get( point( 1, 2 ), -1 ) == -1 );
+    cache.insert( point( 1, 2 ), 1 );
+    cache.insert( point( 2, 1 ), 0 );
+    CHECK( cache.get( point( 1, 2 ), -1 ) == 1 );
+    CHECK( cache.get( point( 2, 1 ), -1 ) == 0 );
+    cache.insert( point( 1, 2 ), 0 );
+    CHECK( cache.get( point( 1, 2 ), -1 ) == 0 );
+
+    cache.clear();
+    CHECK( cache.get( point( 1, 2 ), -1 ) == -1 );
+    CHECK( cache.get( point( 2, 1 ), -1 ) == -1 );
+}
+
+TEST_CASE( "skew_vision_cache_keeps_used_entries_when_full", "[nogame]" )
+{
+    skew_vision_cache cache;
+    const point kept( 12345, 67890 );
+    cache.insert( kept, 1 );
+    // Keys shaped like map::sees_cache_key(), several times more than fit
+    const int count = 4 * skew_vision_cache::set_count * skew_vision_cache::ways;
+    int kept_misses = 0;
+    for( int i = 0; i < count; ++i ) {
+        if( cache.get( kept, -1 ) != 1 ) {
+            ++kept_misses;
+        }
+        cache.insert( point( ( i % 1024 ) << 20 | ( i / 1024 ) << 10, i << 10 ), i % 2 );
+    }
+    CHECK( kept_misses == 0 );
+    // Whatever survived still has the right value
+    int found = 0;
+    for( int i = 0; i < count; ++i ) {
+        const char value = cache.get( point( ( i % 1024 ) << 20 | ( i / 1024 ) << 10, i << 10 ), -1 );
+        if( value != -1 ) {
+            CHECK( value == i % 2 );
+            ++found;
+        }
+    }
+    CHECK( found > count / 8 );
+}
@@ -0,0 +1,33 @@
+#pragma once
+#ifndef CATA_TESTS_TEST_INIT_H
+#define CATA_TESTS_TEST_INIT_H
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "type_id.h"
+
+// Game setup shared by cata_test and cata_bench.
+
+using name_value_pair_t = std::pair<std::string, std::string>;
+using option_overrides_t = std::vector<name_value_pair_t>;
+
+// Parses a comma separated mod list, always adding the test data mod.
+std::vector<mod_id> extract_mod_selection( std::string_view mod_string );
+// Parses "name:value,name:value" pairs.
+option_overrides_t extract_option_overrides( std::string_view option_overrides_string );
+
+// Sets up paths and options in user_dir, creates the game object and loads
+// static data.  No world is loaded.
+void init_test_game( const option_overrides_t &option_overrides, const std::string &user_dir );
+// Creates and loads a fresh world with the given mods, with the avatar at the
+// origin of an overmap without specials.
+void init_test_world( const std::vector<mod_id> &mods );
+// Both of the above.
+void init_global_game_state( const std::vector<mod_id> &mods,
+                             const option_overrides_t &option_overrides,
+                             const std::string &user_dir );
+
+#endif // CATA_TESTS_TEST_INIT_H
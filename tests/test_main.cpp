@@ -50,6 +50,7 @@
 #include "path_info.h"
 #include "point.h"
 #include "rng.h"
+#include "test_init.h"
 #include "type_id.h"
 #include "units.h"
 #include "weather.h"
@@ -58,9 +59,6 @@
 
 static const mod_id MOD_INFORMATION_dda( "dda" );
 
-using name_value_pair_t = std::pair<std::string, std::string>;
-using option_overrides_t = std::vector<name_value_pair_t>;
-
 static std::vector<mod_id> mods;
 static std::string user_dir;
 static bool dont_save{ false };
@@ -75,134 +73,6 @@ static bool fail_to_init_game_state{ false };
 
 static bool game_initialized{ false };
 
-static std::vector<mod_id> extract_mod_selection( const std::string_view mod_string )
-{
-    std::vector<std::string> mod_names = string_split( mod_string, ',' );
-    std::vector<mod_id> ret;
-    for( const std::string &mod_name : mod_names ) {
-        if( !mod_name.empty() ) {
-            ret.emplace_back( mod_name );
-        }
-    }
-    // Always load test data mod
-    ret.emplace_back( "test_data" );
-
-    return ret;
-}
-
-static void init_global_game_state( const std::vector<mod_id> &mods,
-                                    option_overrides_t &option_overrides,
-                                    const std::string &user_dir )
-{
-    if( !assure_dir_exist( user_dir ) ) {
-        // NOLINTNEXTLINE(misc-static-assert,cert-dcl03-c)
-        cata_fatal( "Unable to make user_dir directory '%s'.  Check permissions.", user_dir );
-    }
-
-    PATH_INFO::init_base_path( "" );
-    PATH_INFO::init_user_dir( user_dir );
-    PATH_INFO::set_standard_filenames();
-
-    if( !assure_dir_exist( PATH_INFO::config_dir() ) ) {
-        // NOLINTNEXTLINE(misc-static-assert,cert-dcl03-c)
-        cata_fatal( "Unable to make config directory.  Check permissions." );
-    }
-
-    if( !assure_dir_exist( PATH_INFO::savedir() ) ) {
-        // NOLINTNEXTLINE(misc-static-assert,cert-dcl03-c)
-        cata_fatal( "Unable to make save directory.  Check permissions." );
-    }
-
-    if( !assure_dir_exist( PATH_INFO::templatedir() ) ) {
-        // NOLINTNEXTLINE(misc-static-assert,cert-dcl03-c)
-        cata_fatal( "Unable to make templates directory.  Check permissions." );
-    }
-
-    get_options().init();
-    get_options().load();
-
-    // Apply command-line option overrides for test suite execution.
-    if( !option_overrides.empty() ) {
-        for( const name_value_pair_t &option : option_overrides ) {
-            if( get_options().has_option( option.first ) ) {
-                options_manager::cOpt &opt = get_options().get_option( option.first );
-                opt.setValue( option.second );
-            }
-        }
-    }
-    init_colors();
-
-    g = std::make_unique<game>( );
-    g->new_game = true;
-    g->load_static_data();
-
-    world_generator->set_active_world( nullptr );
-    world_generator->init();
-    // Using unicode characters in the world name to test path encoding
-#ifndef _WIN32
-    const std::string test_world_name = "Test World 测试世界 " + std::to_string( getpid() );
-#else
-    const std::string test_world_name = "Test World 测试世界";
-#endif
-    WORLD *test_world = world_generator->make_new_world( test_world_name, mods );
-    cata_assert( test_world != nullptr );
-    world_generator->set_active_world( test_world );
-    cata_assert( world_generator->active_world != nullptr );
-
-    calendar::set_eternal_season( get_option<bool>( "ETERNAL_SEASON" ) );
-    calendar::set_season_length( get_option<int>( "SEASON_LENGTH" ) );
-
-    g->load_core_data();
-    g->load_world_modfiles();
-
-    get_avatar() = avatar();
-    get_avatar().create( character_type::NOW );
-    get_avatar().setID( g->assign_npc_id(), false );
-
-    get_map() = map();
-
-    overmap_special_batch empty_specials( point_abs_om{} );
-    overmap_buffer.create_custom_overmap( point_abs_om{}, empty_specials );
-
-    map &here = get_map();
-    // TODO: fix point types
-    here.load( tripoint_abs_sm( here.get_abs_sub() ), false );
-    get_avatar().move_to( tripoint_abs_ms::zero );
-
-    get_weather().update_weather();
-}
-
-// Split s on separator sep, returning parts as a pair. Returns empty string as
-// second value if no separator found.
-static name_value_pair_t split_pair( const std::string &s, const char sep )
-{
-    const size_t pos = s.find( sep );
-    if( pos != std::string::npos ) {
-        return name_value_pair_t( s.substr( 0, pos ), s.substr( pos + 1 ) );
-    } else {
-        return name_value_pair_t( s, "" );
-    }
-}
-
-static option_overrides_t extract_option_overrides( const std::string_view option_overrides_string )
-{
-    option_overrides_t ret;
-    const char delim = ',';
-    const char sep = ':';
-    size_t i = 0;
-    size_t pos = option_overrides_string.find( delim );
-    while( pos != std::string::npos ) {
-        std::string part = static_cast<std::string>( option_overrides_string.substr( i, pos ) );
-        ret.emplace_back( split_pair( part, sep ) );
-        i = ++pos;
-        pos = option_overrides_string.find( delim, pos );
-    }
-    // Handle last part
-    const std::string part = static_cast<std::string>( option_overrides_string.substr( i ) );
-    ret.emplace_back( split_pair( part, sep ) );
-    return ret;
-}
-
 struct CataListener : Catch::TestEventListenerBase {
     using TestEventListenerBase::TestEventListenerBase;
 
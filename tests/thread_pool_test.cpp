@@ -0,0 +1,43 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "cata_catch.h"
+#include "thread_pool.h"
+
+TEST_CASE( "thread_pool_runs_every_task_once", "[nogame]" )
+{
+    for( const unsigned int workers : { 0U, 1U, 3U } ) {
+        CAPTURE( workers );
+        thread_pool pool( workers );
+        CHECK( pool.worker_count() == workers );
+        // Several jobs in a row, to make sure workers pick up every new one.
+        for( const size_t count : { 0, 1, 7, 100 } ) {
+            CAPTURE( count );
+            std::vector<int> calls( count, 0 );
+            pool.parallel_for( count, [&]( size_t i ) {
+                ++calls[i];
+            } );
+            CHECK( calls == std::vector<int>( count, 1 ) );
+        }
+    }
+}
+
+TEST_CASE( "thread_pool_rethrows_task_exceptions", "[nogame]" )
+{
+    thread_pool pool( 2 );
+    std::atomic<int> finished( 0 );
+    CHECK_THROWS_AS( pool.parallel_for( 20, [&]( size_t i ) {
+        if( i == 5 ) {
+            throw std::runtime_error( "task failed" );
+        }
+        ++finished;
+    } ), std::runtime_error );
+    // The other tasks still ran, and the pool is still usable.
+    CHECK( finished == 19 );
+    pool.parallel_for( 4, [&]( size_t ) {
+        ++finished;
+    } );
+    CHECK( finished == 23 );
+}
@@ -0,0 +1,113 @@
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "cata_catch.h"
+#include "flexbuffer_json.h"
+#include "json.h"
+#include "json_loader.h"
+#include "perf.h"
+
+static void add_turn( turn_profiler &profiler, int turn, uint64_t monmove_us )
+{
+    profiler.start_turn( turn );
+    profiler.add_sample( turn_phase::monmove, monmove_us );
+    profiler.add_sample( turn_phase::process_fields, 1 );
+    profiler.add_sample( turn_phase::process_fields, 2 );
+    profiler.finish_turn();
+}
+
+TEST_CASE( "turn_profiler_percentiles", "[perf][nogame]" )
+{
+    std::unique_ptr<turn_profiler> profiler = std::make_unique<turn_profiler>();
+    for( int i = 1; i <= 100; ++i ) {
+        add_turn( *profiler, i, i );
+    }
+    REQUIRE( profiler->size() == 100 );
+
+    turn_profiler::phase_stats monmove = profiler->get_stats( turn_phase::monmove );
+    CHECK( monmove.last == 100 );
+    CHECK( monmove.p50 == 50 );
+    CHECK( monmove.p99 == 99 );
+    CHECK( monmove.max == 100 );
+
+    // Samples for the same phase within a turn accumulate
+    CHECK( profiler->get_stats( turn_phase::process_fields ).max == 3 );
+    CHECK( profiler->get_stats( turn_phase::vehmove ).max == 0 );
+    CHECK( profiler->get_total_stats().last == 103 );
+}
+
+TEST_CASE( "turn_profiler_ring_buffer_wraps", "[perf][nogame]" )
+{
+    std::unique_ptr<turn_profiler> profiler = std::make_unique<turn_profiler>();
+    const int turns = static_cast<int>( turn_profiler::history_size ) + 10;
+    for( int i = 0; i < turns; ++i ) {
+        add_turn( *profiler, i, i );
+    }
+    CHECK( profiler->size() == turn_profiler::history_size );
+    CHECK( profiler->get_record( 0 ).turn == turns - 1 );
+    CHECK( profiler->get_record( turn_profiler::history_size - 1 ).turn == 10 );
+
+    // An unfinished turn is not recorded
+    profiler->start_turn( turns );
+    profiler->add_sample( turn_phase::monmove, 5 );
+    CHECK( profiler->get_record( 0 ).turn == turns - 1 );
+
+    profiler->clear();
+    CHECK( profiler->size() == 0 );
+    CHECK( profiler->get_stats( turn_phase::monmove ).max == 0 );
+}
+
+TEST_CASE( "turn_profiler_export", "[perf][nogame]" )
+{
+    std::unique_ptr<turn_profiler> profiler = std::make_unique<turn_profiler>();
+    add_turn( *profiler, 7, 20 );
+    add_turn( *profiler, 8, 30 );
+
+    std::ostringstream csv;
+    profiler->write_csv( csv );
+    CHECK( csv.str() ==
+           "turn,move_hordes,autosave,scent_update,vehmove,process_fields,process_items,"
+           "process_sounds,build_map_cache,monmove,total\n"
+           "7,0,0,0,0,3,0,0,0,20,23\n"
+           "8,0,0,0,0,3,0,0,0,30,33\n" );
+
+    std::ostringstream os;
+    JsonOut jsout( os );
+    profiler->serialize( jsout );
+    JsonValue jv = json_loader::from_string( os.str() );
+    JsonObject jo = jv.get_object();
+    jo.allow_omitted_members();
+    CHECK( jo.get_int( "turns" ) == 2 );
+    JsonObject stats = jo.get_object( "stats" );
+    stats.allow_omitted_members();
+    JsonObject monmove = stats.get_object( "monmove" );
+    monmove.allow_omitted_members();
+    CHECK( monmove.get_int( "last" ) == 30 );
+    CHECK( monmove.get_int( "max" ) == 30 );
+    CHECK( jo.get_array( "history" ).size() == 2 );
+}
+
+TEST_CASE( "turn_phase_timer_is_a_cata_timer_scope", "[perf][nogame]" )
+{
+    turn_profiler &profiler = get_turn_profiler();
+    profiler.clear();
+    cata_timer::reset_stats();
+    profiler.start_turn( 1 );
+    for( int i = 0; i < 2; ++i ) {
+        turn_phase_timer timer( turn_phase::vehmove );
+        CATA_TIMER_SCOPE( "turn_phase_timer_test_inner" );
+    }
+    profiler.finish_turn();
+    REQUIRE( profiler.size() == 1 );
+
+    const cata_timer::timers_map stats = cata_timer::get_stats();
+    const auto phase = stats.find( "turn_phase::vehmove" );
+    REQUIRE( phase != stats.end() );
+    CHECK( phase->second.count == 2 );
+    // Timers inside a phase nest under it
+    CHECK( phase->second.child_timers.count( "turn_phase_timer_test_inner" ) == 1 );
+    CHECK( profiler.get_record( 0 ).phase_us[static_cast<size_t>( turn_phase::vehmove )] <=
+           phase->second.duration + 1 );
+    profiler.clear();
+}
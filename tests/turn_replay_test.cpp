@@ -0,0 +1,91 @@
+#include <sstream>
+#include <string>
+
+#include "cata_catch.h"
+#include "flexbuffer_json.h"
+#include "json.h"
+#include "json_loader.h"
+#include "rng.h"
+#include "string_formatter.h"
+#include "turn_replay.h"
+
+static uint32_t next_rng_output()
+{
+    cata_default_random_engine engine = rng_get_engine();
+    return static_cast<uint32_t>( engine() );
+}
+
+TEST_CASE( "turn_replay_round_trip_and_divergence", "[perf][nogame]" )
+{
+    const cata_default_random_engine saved_engine = rng_get_engine();
+    rng_set_engine_seed( 1234 );
+    const uint32_t check = next_rng_output();
+
+    const std::string log = string_format(
+                                R"({"version":1,"world":"Bench","save":"Tester","start_turn":100,"seed":1234,)"
+                                R"("actions":["wait","move_n"],"turns":[[%u,500,1,0],[%u,700],[%u,900,0]]})",
+                                check, check, check );
+    turn_replay replay;
+    replay.deserialize( json_loader::from_string( log ) );
+    CHECK( replay.get_world() == "Bench" );
+    CHECK( replay.get_save_id() == "Tester" );
+    CHECK( replay.get_start_turn() == 100 );
+    CHECK( replay.get_seed() == 1234 );
+    REQUIRE( replay.get_turns().size() == 3 );
+    CHECK( replay.get_turns()[0].total_us == 500 );
+    CHECK( replay.get_turns()[1].actions.empty() );
+
+    std::ostringstream os;
+    JsonOut jsout( os );
+    replay.serialize( jsout );
+    CHECK( os.str() == log );
+
+    rng_set_engine_seed( 42 );
+    replay.start_replay();
+    // The first turn consumes no randomness, so it matches the recording
+    CHECK( replay.next_action() == "move_n" );
+    CHECK( replay.next_action() == "wait" );
+    CHECK_THROWS( replay.next_action() );
+    replay.end_turn( 450 );
+    CHECK( !replay.first_divergence() );
+
+    // The second turn rolls once more than recorded
+    rng( 0, 1 );
+    replay.end_turn( 800 );
+    REQUIRE( replay.first_divergence() );
+    CHECK( *replay.first_divergence() == 1 );
+
+    CHECK( !replay.replay_finished() );
+    CHECK( replay.next_action() == "wait" );
+    replay.end_turn( 1000 );
+    CHECK( replay.replay_finished() );
+    CHECK( replay.replayed_turns() == 3 );
+    CHECK( replay.replayed_us( 1 ) == 800 );
+    CHECK_THROWS( replay.next_action() );
+
+    rng_get_engine() = saved_engine;
+}
+
+TEST_CASE( "turn_replay_abort_stops_feeding_actions", "[perf][nogame]" )
+{
+    const cata_default_random_engine saved_engine = rng_get_engine();
+    turn_replay replay;
+    replay.deserialize( json_loader::from_string(
+                            R"({"version":1,"world":"Bench","save":"Tester","start_turn":100,"seed":1234,)"
+                            R"("actions":["wait"],"turns":[[0,500,0],[0,700,0]]})" ) );
+    replay.start_replay();
+    CHECK( replay.next_action() == "wait" );
+    replay.end_turn( 450 );
+    // The second turn throws before it is over
+    CHECK( replay.next_action() == "wait" );
+    replay.abort_replay();
+    CHECK( !replay.is_replaying() );
+    REQUIRE( replay.aborted_turn() );
+    CHECK( *replay.aborted_turn() == 1 );
+    CHECK( replay.replayed_turns() == 1 );
+
+    replay.start_replay();
+    CHECK( replay.is_replaying() );
+    CHECK( !replay.aborted_turn() );
+    rng_get_engine() = saved_engine;
+}